@@ -0,0 +1,49 @@
+#!/usr/bin/env sh
+# Zero-cost check : the `zero_cost_*` probes of game_example.cpp make the same call
+# unconstrained, through concepts and through std::enable_if.
+# Their generated instructions must be identical, at -O2 and -O3.
+#
+# usage   : ./check_zero_cost.sh [compiler]      (default : $CXX, then c++)
+# exit    : 0 identical, 1 a constrained probe differs, 2 a probe body could not be extracted
+# support : GCC and Clang, emitting GNU-style assembly (ELF on Linux, Mach-O on macOS).
+#           MSVC is not supported.
+
+set -eu
+
+compiler="${1:-${CXX:-c++}}"
+source_file="$(dirname "$0")/game_example.cpp"
+work_directory="$(mktemp -d)"
+trap 'rm -rf "$work_directory"' EXIT
+
+# body of `zero_cost_$1` (Mach-O prefixes symbols with `_`), without labels, directives nor comments
+extract() {
+    sed -n "/^_\{0,1\}zero_cost_$1:/,/\.cfi_endproc/p" "$work_directory/game_example.s" \
+    | grep -v \
+        -e '^_\{0,1\}zero_cost_' \
+        -e '^[[:space:]]*\.' \
+        -e '^L[[:alnum:]_]*:' \
+        -e '^[[:space:]]*[#;@]' \
+        -e '^[[:space:]]*$' \
+    || true
+}
+
+status=0
+for level in -O2 -O3; do
+    "$compiler" -std=c++20 "$level" -S -o "$work_directory/game_example.s" "$source_file"
+    for probe in plain cpp20 cpp17; do
+        extract "$probe" > "$work_directory/$probe.s"
+        if [ ! -s "$work_directory/$probe.s" ]; then
+            echo "error : no instructions extracted for zero_cost_$probe ($level)" >&2
+            exit 2
+        fi
+    done
+    for probe in cpp20 cpp17; do
+        if diff -u "$work_directory/plain.s" "$work_directory/$probe.s"; then
+            echo "zero_cost_$probe ($level) : same as zero_cost_plain"
+        else
+            echo "zero_cost_$probe ($level) : DIFFERS from zero_cost_plain" >&2
+            status=1
+        fi
+    done
+done
+exit "$status"
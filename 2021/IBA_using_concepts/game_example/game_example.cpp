@@ -10,6 +10,7 @@
 // --- concepts definitions
 
 #include <concepts>
+#include <span>
 namespace concepts::cpp20
 {
     template <typename T>
@@ -18,6 +19,13 @@ namespace concepts::cpp20
         value.behave();
     };
 
+    // opt-in : processes a whole contiguous range at once
+    template <typename T>
+    concept can_behave_batch = can_behave<T> and requires(std::span<T> values)
+    {
+        T::behave_batch(values);
+    };
+
     template <typename T>
     concept has_hp_getter = requires(const T value)
     {
@@ -45,6 +53,12 @@ namespace concepts::cpp17
     struct can_behave<T, std::void_t<decltype(std::declval<T>().behave())>>
     : std::true_type{};
 
+    template <typename T, typename = void>
+    struct can_behave_batch : std::false_type{};
+    template <typename T>
+    struct can_behave_batch<T, std::void_t<decltype(T::behave_batch(std::declval<std::span<T>>()))>>
+    : can_behave<T>{};
+
     // detection idiom + return value check
     template <typename T, typename = void>
     struct has_hp_getter : std::false_type{};
@@ -72,8 +86,10 @@ namespace usage::cpp20
 {
     using namespace concepts::cpp20;
     template <entity entity_type>
-    void use_entity(entity_type &&)
-    {}
+    void use_entity(entity_type && value)
+    {
+        value.behave();
+    }
 
     void usage()
     {
@@ -89,24 +105,43 @@ namespace usage::cpp17
         typename entity_type,
         typename = std::enable_if_t<concepts::cpp17::is_entity<entity_type>::value>
     >
-    void use_entity(entity_type &&)
-    {}
+    void use_entity(entity_type && value)
+    {
+        value.behave();
+    }
 
     void usage()
     {
         use_entity(entity_implementation{});
     }
+
+    // prefers the batch contract when available
+    template <
+        typename entity_type,
+        typename = std::enable_if_t<concepts::cpp17::can_behave<entity_type>::value>
+    >
+    void behave_all(std::span<entity_type> values)
+    {
+        if constexpr (concepts::cpp17::can_behave_batch<entity_type>::value)
+            entity_type::behave_batch(values);
+        else
+            for (auto & value : values)
+                value.behave();
+    }
 }
 
 // --- Type erasure
 #include <memory>
+#include <vector>
+#include <algorithm>
+#include "../type_identity.hpp"
 namespace type_erasure::cpp17
 {
     struct any_entity
     {
         template <typename T> // C++20 : template <concepts::cpp2::entity or requires clause
         any_entity(T && arg)
-        : value_accessor{ std::make_unique<wrapper<T>>(std::forward<decltype(arg)>(arg)) }
+        : value_accessor{ make_model(std::forward<decltype(arg)>(arg)) }
         {
             static_assert(concepts::cpp17::is_entity<T>::value);
         }
@@ -114,33 +149,205 @@ namespace type_erasure::cpp17
         void behave() {
             value_accessor->behave();
         }
+        // batch contract : one virtual call per run of consecutive elements of the same type
+        static void behave_batch(std::span<any_entity> values)
+        {
+            for (auto first = std::begin(values); first != std::end(values);)
+            {
+                const auto key = first->type_key();
+                const auto last = std::find_if(std::next(first), std::end(values), [key](const any_entity & element){
+                    return element.type_key() != key;
+                });
+                first->value_accessor->behave_run(std::span{ first, last });
+                first = last;
+            }
+        }
         auto get_hp() const {
             return value_accessor->get_hp();
         }
 
+        // identifies the dynamic type : `mp::type_id_v` of the wrapped type, stable across builds
+        using type_key_type = std::uint64_t;
+        auto type_key() const -> type_key_type {
+            return value_accessor->type_key();
+        }
+        auto type_name() const -> std::string_view {
+            return value_accessor->type_name();
+        }
+        void prefetch() const {
+        #if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(model_address());
+        #endif
+        }
+        // shared by all instances of a stateless type
+        auto model_address() const -> const void * {
+            return value_accessor.get();
+        }
+
     private:
         struct model
         {
             virtual ~model() = default;
             virtual void behave() = 0;
+            virtual void behave_run(std::span<any_entity> run) = 0;
             virtual unsigned int get_hp() const = 0;
+            virtual type_key_type type_key() const = 0;
+            virtual std::string_view type_name() const = 0;
+            virtual void release() { delete this; }
         };
+        static constexpr auto prefetch_distance = std::size_t{ 4 };
+
         template <typename T>
         struct wrapper : model
         {
-            wrapper(T && arg)
+            template <typename U>
+            wrapper(U && arg)
             : value{std::forward<decltype(arg)>(arg)}
             {}
             ~wrapper() override {}
             void behave() override { value.behave(); }
+            // every element of `run` wraps a T : direct calls, batch contract preferred.
+            // Elements of a run share a type but not a memory region : the next models are fetched ahead.
+            void behave_run(std::span<any_entity> run) override
+            {
+                const auto value_of = [](any_entity & element) -> T & {
+                    return static_cast<wrapper &>(*element.value_accessor).value;
+                };
+                const auto size = run.size();
+                if constexpr (concepts::cpp17::can_behave_batch<T>::value)
+                {   // values are not contiguous : gathered, processed at once, then written back
+                    thread_local auto values = std::vector<T>{};
+                    values.clear();
+                    for (std::size_t index = 0; index != size; ++index)
+                    {
+                        if (index + prefetch_distance < size)
+                            run[index + prefetch_distance].prefetch();
+                        values.push_back(std::move(value_of(run[index])));
+                    }
+                    usage::cpp17::behave_all(std::span{ values });
+                    for (std::size_t index = 0; index != size; ++index)
+                        value_of(run[index]) = std::move(values[index]);
+                }
+                else
+                    for (std::size_t index = 0; index != size; ++index)
+                    {
+                        if (index + prefetch_distance < size)
+                            run[index + prefetch_distance].prefetch();
+                        value_of(run[index]).behave();
+                    }
+            }
             unsigned int get_hp() const override { return value.get_hp(); }
+            type_key_type type_key() const override { return mp::type_id_v<T>; }
+            std::string_view type_name() const override { return mp::type_name_v<T>; }
         private:
             T value;
         };
-        std::unique_ptr<model> value_accessor;
+        // no state, and nothing observable in copying nor destroying it :
+        // collapsing all instances into one is invisible to the value type
+        template <typename T>
+        static constexpr bool is_stateless_v =
+            std::is_empty_v<T> and
+            std::is_trivially_copy_constructible_v<T> and
+            std::is_trivially_destructible_v<T>
+        ;
+        // flyweight : one model shared by all instances of a stateless type
+        template <typename T>
+        struct shared_wrapper final : wrapper<T>
+        {
+            using wrapper<T>::wrapper;
+            void release() override {}
+        };
+        struct model_deleter
+        {
+            void operator()(model * value) const { value->release(); }
+        };
+        using model_pointer = std::unique_ptr<model, model_deleter>;
+
+        template <typename T>
+        static auto make_model(T && arg) -> model_pointer
+        {
+            using value_type = std::decay_t<T>;
+            if constexpr (is_stateless_v<value_type>)
+            {
+                static auto shared_model = shared_wrapper<value_type>{ value_type{ std::forward<decltype(arg)>(arg) } };
+                return model_pointer{ &shared_model };
+            }
+            else
+                return model_pointer{ new wrapper<value_type>(std::forward<decltype(arg)>(arg)) };
+        }
+
+        model_pointer value_accessor;
     };
 
     static_assert(concepts::cpp17::is_entity<type_erasure::cpp17::any_entity>::value);
+    static_assert(sizeof(any_entity) == sizeof(void*)); // stateless deleter : dispatch pointer only
+    static_assert(concepts::cpp17::can_behave_batch<any_entity>::value);
+}
+
+namespace type_erasure::cpp17
+{
+    // Keeps elements grouped by dynamic type, so that iterating calls the same
+    // behave() target many times in a row (indirect branches stay predictable).
+    class clustered_entity_collection
+    {
+    public:
+        using value_type = any_entity;
+        using container_type = std::vector<value_type>;
+
+        // incremental : inserted at the end of its type's run
+        // (reclusters first if previous `push_back`s broke the ordering)
+        template <typename T>
+        void insert(T && arg)
+        {
+            if (not clustered)
+                recluster();
+            auto value = value_type{ std::forward<decltype(arg)>(arg) };
+            const auto position = std::upper_bound(
+                std::begin(elements), std::end(elements),
+                value.type_key(),
+                [](any_entity::type_key_type key, const value_type & element){
+                    return key < element.type_key();
+                }
+            );
+            elements.insert(position, std::move(value));
+        }
+        // cheap append, breaks clustering until the next `recluster()`
+        template <typename T>
+        void push_back(T && arg)
+        {
+            elements.emplace_back(std::forward<decltype(arg)>(arg));
+            clustered = clustered and (
+                elements.size() == 1 or
+                not (elements.back().type_key() < elements[elements.size() - 2].type_key())
+            );
+        }
+        void recluster()
+        {
+            clustered = true;
+            std::stable_sort(
+                std::begin(elements), std::end(elements),
+                [](const value_type & lhs, const value_type & rhs){
+                    return lhs.type_key() < rhs.type_key();
+                }
+            );
+        }
+
+        // one run per type (reclusters first if needed), see `any_entity::behave_batch`
+        void behave_all()
+        {
+            if (not clustered)
+                recluster();
+            usage::cpp17::behave_all(std::span{ elements });
+        }
+
+        auto size() const { return elements.size(); }
+        auto begin() const { return std::cbegin(elements); }
+        auto end() const { return std::cend(elements); }
+
+    private:
+        container_type elements;
+        bool clustered = true; // elements sorted by type_key
+    };
 }
 
 namespace usage
@@ -159,6 +366,15 @@ namespace usage
         {
             hp -= 1;
         }
+        void damage(unsigned int amount)
+        {
+            hp -= std::min(amount, hp);
+        }
+        static void behave_batch(std::span<monster> values)
+        {   // inlined behave() over contiguous values : vectorizable
+            for (auto & value : values)
+                value.behave();
+        }
         auto get_hp() const { return hp; }
 
     private:
@@ -166,10 +382,45 @@ namespace usage
     };
 }
 
-#include <vector>
+// --- Zero-cost check
+// Same call, unconstrained vs. constrained : generated code is expected to be identical.
+// `check_zero_cost.sh` compares these probes' instructions, and fails on any difference.
+namespace zero_cost
+{
+    extern "C" [[gnu::noinline]] void zero_cost_plain(usage::monster & value)
+    {
+        value.behave();
+    }
+    extern "C" [[gnu::noinline]] void zero_cost_cpp20(usage::monster & value)
+    {
+        usage::cpp20::use_entity(value);
+    }
+    extern "C" [[gnu::noinline]] void zero_cost_cpp17(usage::monster & value)
+    {
+        usage::cpp17::use_entity(value);
+    }
+}
+
 #include <numeric>
+#include <cassert>
+#include <string>
 namespace usage::cpp17
 {
+    void check_flyweight()
+    {
+        using type_erasure::cpp17::any_entity;
+
+        const auto first_hero = any_entity{ hero{} };
+        const auto second_hero = any_entity{ hero{} };
+        assert(first_hero.type_key() == second_hero.type_key());
+        assert(first_hero.model_address() == second_hero.model_address());
+
+        const auto first_monster = any_entity{ monster{ 42 } };
+        const auto second_monster = any_entity{ monster{ 42 } };
+        assert(first_monster.type_key() == second_monster.type_key());
+        assert(first_monster.model_address() != second_monster.model_address());
+    }
+
     auto use_entity_type_erasure()
     {
         using namespace type_erasure::cpp17;
@@ -181,10 +432,7 @@ namespace usage::cpp17
         entity_collection.emplace_back(hero{});
         entity_collection.emplace_back(monster{42});
 
-        for (auto & element : entity_collection)
-        {
-            element.behave();
-        }
+        behave_all(std::span{ entity_collection }); // any_entity::behave_batch
         return std::accumulate(
             std::cbegin(entity_collection),
             std::cend(entity_collection),
@@ -194,6 +442,28 @@ namespace usage::cpp17
             }
         );
     }
+
+    // runs are logged by type name : same identity as the clustering keys
+    auto use_clustered_collection()
+    {
+        auto entity_collection = type_erasure::cpp17::clustered_entity_collection{};
+        entity_collection.push_back(hero{});
+        entity_collection.push_back(monster{ 42 });
+        entity_collection.push_back(hero{});
+        entity_collection.insert(monster{ 13 }); // reclusters first
+        entity_collection.behave_all();
+
+        auto description = std::string{};
+        for (auto first = std::begin(entity_collection); first != std::end(entity_collection);)
+        {
+            const auto last = std::find_if(first, std::end(entity_collection), [key = first->type_key()](const auto & element){
+                return element.type_key() != key;
+            });
+            description += (description.empty() ? "" : ", ") + std::string{ first->type_name() } + " x" + std::to_string(std::distance(first, last));
+            first = last;
+        }
+        return description;
+    }
 }
 
 #include <variant>
@@ -202,6 +472,48 @@ namespace usage::cpp20
     template <concepts::cpp20::entity ... entities_type>
     using entity_variant = std::variant<entities_type...>;
 
+    // prefers the batch contract when available (subsumes can_behave)
+    template <concepts::cpp20::can_behave entity_type>
+    void behave_all(std::span<entity_type> values)
+    {
+        for (auto & value : values)
+            value.behave();
+    }
+    template <concepts::cpp20::can_behave_batch entity_type>
+    void behave_all(std::span<entity_type> values)
+    {
+        entity_type::behave_batch(values);
+    }
+
+    // variants : one std::visit per run of the same alternative, batch contract preferred
+    template <concepts::cpp20::entity ... entities_type>
+    void behave_all(std::span<entity_variant<entities_type...>> values)
+    {
+        for (auto first = std::begin(values); first != std::end(values);)
+        {
+            const auto last = std::find_if(std::next(first), std::end(values), [index = first->index()](const auto & element){
+                return element.index() != index;
+            });
+            std::visit([run = std::span{ first, last }]<typename entity_type>(entity_type &){
+                const auto value_of = [](auto & element) -> entity_type & { return *std::get_if<entity_type>(&element); };
+                if constexpr (concepts::cpp20::can_behave_batch<entity_type>)
+                {   // values are not contiguous : gathered, processed at once, then written back
+                    thread_local auto gathered = std::vector<entity_type>{};
+                    gathered.clear();
+                    for (auto & element : run)
+                        gathered.push_back(std::move(value_of(element)));
+                    behave_all(std::span{ gathered });
+                    for (std::size_t index = 0; auto & element : run)
+                        value_of(element) = std::move(gathered[index++]);
+                }
+                else
+                    for (auto & element : run)
+                        value_of(element).behave();
+            }, *first);
+            first = last;
+        }
+    }
+
     auto use_entity_type_erasure()
     {
         using element_type = entity_variant<hero, monster>;
@@ -212,13 +524,7 @@ namespace usage::cpp20
             element_type{42}
         };
 
-        const auto behave_visitor = [](auto & any_entity){
-            any_entity.behave();
-        };
-        for (auto & element : entity_collection)
-        {
-            std::visit(behave_visitor, element);
-        }
+        behave_all(std::span{ entity_collection }); // one std::visit per run
         return std::accumulate(
             std::cbegin(entity_collection),
             std::cend(entity_collection),
@@ -233,6 +539,995 @@ namespace usage::cpp20
     }
 }
 
+namespace usage::cpp20
+{
+    static_assert(not concepts::cpp20::can_behave_batch<hero>);
+    static_assert(concepts::cpp20::can_behave_batch<monster>);
+    static_assert(concepts::cpp17::can_behave_batch<monster>::value);
+
+    auto use_entity_batches()
+    {   // one homogeneous collection per entity type
+        auto heroes = std::vector<hero>(2);
+        auto monsters = std::vector<monster>{ monster{ 42 }, monster{ 13 } };
+
+        behave_all(std::span{ heroes });    // per-object behave()
+        behave_all(std::span{ monsters });  // monster::behave_batch
+
+        const auto sum_hp = [](auto intermediate_sum, const auto & element){
+            return element.get_hp() + intermediate_sum;
+        };
+        return
+            std::accumulate(std::cbegin(heroes), std::cend(heroes), 0u, sum_hp) +
+            std::accumulate(std::cbegin(monsters), std::cend(monsters), 0u, sum_hp)
+        ;
+    }
+}
+
+// --- Concurrent spawns
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <optional>
+namespace spawning::cpp20
+{
+    // Lock-free, multi-producer / single-consumer.
+    // Producers push onto an intrusive stack (CAS loop, no ABA : nodes are never popped one by one),
+    // the owner detaches the whole stack with a single exchange at tick boundaries.
+    // Nodes come from per-producer pools, and go back to them once drained.
+    //
+    // Back-pressure : `try_spawn` never allocates, and fails while all of its producer's nodes are pending.
+    // `spawn` never fails : once the pool is exhausted, it allocates the node instead.
+    template <concepts::cpp20::entity entity_type>
+    class spawn_queue
+    {
+    public:
+        class producer;
+
+    private:
+        struct node
+        {
+            std::optional<entity_type> value;
+            node * next = nullptr;
+            producer * owner = nullptr; // nullptr : allocated by `spawn` on pool exhaustion
+        };
+
+    public:
+        // Spawn handle for one thread at a time, owning `capacity` nodes.
+        class producer
+        {
+        public:
+            producer(spawn_queue & queue_arg, std::size_t capacity_arg)
+            : queue{ queue_arg }
+            , capacity{ capacity_arg }
+            , nodes{ std::make_unique<node[]>(capacity_arg) }
+            {
+                for (std::size_t index = 0; index != capacity; ++index)
+                {
+                    nodes[index].owner = this;
+                    nodes[index].next = std::exchange(available, &nodes[index]);
+                }
+            }
+            producer(const producer &) = delete;
+            producer & operator=(const producer &) = delete;
+
+            // lock-free, no allocation.
+            // false when all of this producer's nodes are pending : retry after the owner's next drain
+            template <typename ... args_types>
+            auto try_spawn(args_types && ... args) -> bool
+            {
+                auto * value = take_available();
+                if (not value)
+                    return false;
+                value->value.emplace(std::forward<decltype(args)>(args)...);
+                queue.push(value);
+                return true;
+            }
+            // lock-free, allocates only once the pool is exhausted
+            template <typename ... args_types>
+            void spawn(args_types && ... args)
+            {
+                auto * value = take_available();
+                if (not value)
+                    value = new node{};
+                value->value.emplace(std::forward<decltype(args)>(args)...);
+                queue.push(value);
+            }
+
+        private:
+            friend spawn_queue;
+            auto take_available() -> node *
+            {
+                if (not available)
+                    available = recycled.exchange(nullptr, std::memory_order_acquire);
+                if (not available)
+                    return nullptr;
+                return std::exchange(available, available->next);
+            }
+            // queue's owner thread
+            void recycle(node * value)
+            {
+                value->value.reset();
+                value->next = recycled.load(std::memory_order_relaxed);
+                while (not recycled.compare_exchange_weak(
+                    value->next, value,
+                    std::memory_order_release,
+                    std::memory_order_relaxed
+                ))
+                {}
+            }
+
+            spawn_queue & queue;
+            std::size_t capacity;
+            std::unique_ptr<node[]> nodes;
+            node * available = nullptr;             // producer's thread only
+            std::atomic<node*> recycled = nullptr;  // pushed by the owner, taken all at once by the producer
+        };
+
+        // gives the producer back to its queue, for a later `make_producer` to reuse
+        struct producer_deleter
+        {
+            void operator()(producer * value) const { value->queue.release(value); }
+        };
+        using producer_handle = std::unique_ptr<producer, producer_deleter>;
+
+        spawn_queue() = default;
+        spawn_queue(const spawn_queue &) = delete;
+        spawn_queue & operator=(const spawn_queue &) = delete;
+        ~spawn_queue()
+        {
+            detached_list{ head.exchange(nullptr, std::memory_order_acquire) };
+        }
+
+        // any thread (locks : call it once per thread, not per spawn).
+        // Reuses the most recently released producer of at least `capacity` nodes, if any.
+        // Handles must not outlive the queue.
+        auto make_producer(std::size_t capacity) -> producer_handle
+        {
+            const auto lock = std::scoped_lock{ producers_mutex };
+            for (auto index = released_producers.size(); index-- != 0;)
+            {
+                if (released_producers[index]->capacity < capacity)
+                    continue;
+                auto * value = released_producers[index];
+                released_producers.erase(std::next(std::begin(released_producers), static_cast<std::ptrdiff_t>(index)));
+                return producer_handle{ value };
+            }
+            return producer_handle{ &producers.emplace_back(*this, capacity) };
+        }
+
+        // owner thread only : moves pending spawns into `collection`, in spawn order,
+        // reserving capacity once for the whole batch.
+        template <typename collection_type>
+        auto drain_into(collection_type & collection) -> std::size_t
+        {
+            auto * pending = head.exchange(nullptr, std::memory_order_acquire);
+
+            node * ordered = nullptr; // LIFO -> FIFO
+            std::size_t count = 0;
+            for (; pending; ++count)
+                ordered = std::exchange(pending, std::exchange(pending->next, ordered));
+
+            auto list = detached_list{ ordered };
+            collection.reserve(collection.size() + count);
+            while (list.first)
+            {
+                collection.emplace_back(std::move(*list.first->value));
+                recycle(std::exchange(list.first, list.first->next));
+            }
+            return count;
+        }
+
+    private:
+        // gives every node it still holds back to its producer, even if draining throws
+        struct detached_list
+        {
+            node * first;
+            ~detached_list()
+            {
+                while (first)
+                    recycle(std::exchange(first, first->next));
+            }
+        };
+
+        static void recycle(node * value)
+        {
+            if (value->owner)
+                value->owner->recycle(value);
+            else
+                delete value;
+        }
+        void push(node * value)
+        {
+            value->next = head.load(std::memory_order_relaxed);
+            while (not head.compare_exchange_weak(
+                value->next, value,
+                std::memory_order_release,
+                std::memory_order_relaxed
+            ))
+            {}
+        }
+        void release(producer * value)
+        {
+            const auto lock = std::scoped_lock{ producers_mutex };
+            released_producers.push_back(value);
+        }
+
+        std::mutex producers_mutex;
+        std::deque<producer> producers;             // stable addresses, live as long as the queue
+        std::vector<producer*> released_producers;
+        std::atomic<node*> head = nullptr;
+    };
+}
+
+#include <thread>
+namespace usage::cpp20
+{
+    auto use_spawn_queue()
+    {
+        auto spawns = spawning::cpp20::spawn_queue<monster>{};
+        {   // network, scripting, AI ...
+            auto producers = std::vector<std::jthread>{};
+            for (auto hp : { 10u, 20u, 30u })
+                producers.emplace_back([&spawns, hp]{
+                    const auto producer = spawns.make_producer(1);
+                    producer->spawn(hp);
+                    if (not producer->try_spawn(hp))    // pool exhausted until the next drain
+                        producer->spawn(hp);            // allocates instead
+                });
+        }
+        {   // released producers are reused, not leaked
+            [[maybe_unused]] const auto * released = spawns.make_producer(1).get();
+            assert(spawns.make_producer(1).get() == released);
+        }
+
+        // tick boundary
+        auto monsters = std::vector<monster>{};
+        spawns.drain_into(monsters);
+
+        behave_all(std::span{ monsters });
+        return std::accumulate(
+            std::cbegin(monsters),
+            std::cend(monsters),
+            0u,
+            [](auto intermediate_sum, const monster & element){
+                return element.get_hp() + intermediate_sum;
+            }
+        );
+    }
+}
+
+// --- Record & replay
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+namespace replay
+{
+    // Binary log format : a sequence of LEB128 varints.
+    // Each event starts with a header `(payload << 3) | event_kind`,
+    // entity indexes are zigzag-encoded deltas from the previous event's index,
+    // so that a typical tick (neighbouring indexes, small hp changes) costs a couple of bytes per event.
+    //
+    // Within a tick, inputs (spawns, despawns, interactions) come first,
+    // then the hp changes the entity loop produced : see `live_world`.
+    // An interaction's outcome is the damage dealt by lhs to rhs.
+    enum class event_kind : std::uint8_t { tick, spawn, despawn, hp_change, interaction };
+    enum class entity_kind : std::uint8_t { hero, monster };
+
+    struct spawn_event { entity_kind kind; unsigned int hp; };
+    struct despawn_event { std::size_t index; };
+    struct hp_change_event { std::size_t index; std::int64_t delta; };
+    struct interaction_event { std::size_t lhs; std::size_t rhs; std::uint8_t outcome; };
+
+    namespace encoding
+    {
+        constexpr auto zigzag(std::int64_t value) -> std::uint64_t
+        {
+            return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+        }
+        constexpr auto unzigzag(std::uint64_t value) -> std::int64_t
+        {
+            return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+        }
+        static_assert(unzigzag(zigzag(-42)) == -42);
+        static_assert(zigzag(-1) == 1 and zigzag(1) == 2);
+    }
+
+    class recorder
+    {
+    public:
+        explicit recorder(std::size_t reserved_bytes = 4096)
+        {
+            buffer.reserve(reserved_bytes);
+        }
+
+        void begin_tick()
+        {
+            write_header(event_kind::tick, 0);
+        }
+        void record(const spawn_event & event)
+        {
+            write_header(event_kind::spawn, static_cast<std::uint64_t>(event.kind));
+            write(event.hp);
+        }
+        void record(const despawn_event & event)
+        {
+            write_header(event_kind::despawn, index_delta(event.index));
+        }
+        void record(const hp_change_event & event)
+        {
+            write_header(event_kind::hp_change, index_delta(event.index));
+            write(encoding::zigzag(event.delta));
+        }
+        void record(const interaction_event & event)
+        {
+            write_header(event_kind::interaction, index_delta(event.lhs));
+            write(encoding::zigzag(static_cast<std::int64_t>(event.rhs - event.lhs)));
+            write(event.outcome);
+        }
+
+        auto data() const -> std::span<const std::uint8_t> { return buffer; }
+
+    private:
+        // throws std::out_of_range if the delta does not fit in a header's payload (61 bits)
+        auto index_delta(std::size_t index) -> std::uint64_t
+        {
+            const auto delta = encoding::zigzag(static_cast<std::int64_t>(index - last_index));
+            if (delta >> 61)
+                throw std::out_of_range{ "recorder : index delta" };
+            last_index = index;
+            return delta;
+        }
+        void write_header(event_kind kind, std::uint64_t payload)
+        {   // payload < 2^61 : see `index_delta`
+            write((payload << 3) | static_cast<std::uint64_t>(kind));
+        }
+        void write(std::uint64_t value)
+        {
+            for (; value >= 0x80; value >>= 7)
+                buffer.push_back(static_cast<std::uint8_t>(value | 0x80));
+            buffer.push_back(static_cast<std::uint8_t>(value));
+        }
+
+        std::vector<std::uint8_t> buffer;
+        std::size_t last_index = 0;
+    };
+
+    // Decodes a log one tick at a time, passing typed events to `handler`.
+    // The handler returns false to reject an event it cannot apply (e.g. an unknown entity index).
+    class replayer
+    {
+    public:
+        explicit replayer(std::span<const std::uint8_t> log_arg)
+        : log{ log_arg }
+        {}
+
+        // returns false once the log is exhausted, or on error : see `failed()`
+        template <typename handler_type>
+        auto next_tick(handler_type && handler) -> bool
+        {
+            if (failure or position == log.size())
+                return false;
+
+            for (bool in_tick = false; position != log.size();)
+            {
+                const auto checkpoint = position;
+                const auto header = read();
+                if (not header)
+                    return fail();
+                const auto payload = *header >> 3;
+                switch (static_cast<event_kind>(*header & 0b111))
+                {
+                    case event_kind::tick:
+                        if (std::exchange(in_tick, true))
+                        {   // next tick : leave it for the next call
+                            position = checkpoint;
+                            return end_tick(handler);
+                        }
+                        break;
+                    case event_kind::spawn:
+                    {
+                        const auto hp = read();
+                        if (not hp or payload > static_cast<std::uint64_t>(entity_kind::monster))
+                            return fail();
+                        if (not handler(spawn_event{ static_cast<entity_kind>(payload), static_cast<unsigned int>(*hp) }))
+                            return fail();
+                        break;
+                    }
+                    case event_kind::despawn:
+                        if (not handler(despawn_event{ apply_delta(payload) }))
+                            return fail();
+                        break;
+                    case event_kind::hp_change:
+                    {
+                        const auto index = apply_delta(payload);
+                        const auto delta = read();
+                        if (not delta or not handler(hp_change_event{ index, encoding::unzigzag(*delta) }))
+                            return fail();
+                        break;
+                    }
+                    case event_kind::interaction:
+                    {
+                        const auto lhs = apply_delta(payload);
+                        const auto rhs_delta = read();
+                        const auto outcome = rhs_delta ? read() : std::nullopt;
+                        if (not outcome)
+                            return fail();
+                        const auto rhs = lhs + static_cast<std::size_t>(encoding::unzigzag(*rhs_delta));
+                        if (not handler(interaction_event{ lhs, rhs, static_cast<std::uint8_t>(*outcome) }))
+                            return fail();
+                        break;
+                    }
+                    default:
+                        return fail();
+                }
+            }
+            return end_tick(handler);
+        }
+        // truncated or corrupted log, or an event (or tick) rejected by the handler
+        auto failed() const -> bool { return failure; }
+
+    private:
+        // optional : `handler.end_tick()` runs once all of the tick's events are applied
+        template <typename handler_type>
+        auto end_tick(handler_type & handler) -> bool
+        {
+            if constexpr (requires { { handler.end_tick() } -> std::convertible_to<bool>; })
+                if (not handler.end_tick())
+                    return fail();
+            return true;
+        }
+        auto fail() -> bool
+        {
+            failure = true;
+            return false;
+        }
+        auto apply_delta(std::uint64_t zigzag_delta) -> std::size_t
+        {
+            return last_index += static_cast<std::size_t>(encoding::unzigzag(zigzag_delta));
+        }
+        auto read() -> std::optional<std::uint64_t>
+        {
+            std::uint64_t value = 0;
+            for (unsigned shift = 0; position != log.size() and shift < 64; shift += 7)
+            {
+                const auto byte = log[position++];
+                value |= std::uint64_t{ byte & 0x7fu } << shift;
+                if (not (byte & 0x80))
+                    return value;
+            }
+            return std::nullopt;
+        }
+
+        std::span<const std::uint8_t> log;
+        std::size_t position = 0;
+        std::size_t last_index = 0;
+        bool failure = false;
+    };
+
+    // Headless state : hp only, no behaviors. Despawn swaps with the last entity, then pops.
+    // Re-applies the recorded hp changes : much faster than real time, but runs none of the entities' code.
+    struct headless_world
+    {
+        struct entity_state { entity_kind kind; unsigned int hp; };
+
+        std::vector<entity_state> entities;
+        std::size_t interactions = 0;
+
+        auto operator()(const spawn_event & event) -> bool
+        {
+            entities.push_back({ event.kind, event.hp });
+            return true;
+        }
+        auto operator()(const despawn_event & event) -> bool
+        {
+            if (event.index >= entities.size())
+                return false;
+            entities[event.index] = entities.back();
+            entities.pop_back();
+            return true;
+        }
+        auto operator()(const hp_change_event & event) -> bool
+        {
+            if (event.index >= entities.size())
+                return false;
+            entities[event.index].hp = static_cast<unsigned int>(entities[event.index].hp + event.delta);
+            return true;
+        }
+        auto operator()(const interaction_event & event) -> bool
+        {
+            if (event.lhs >= entities.size() or event.rhs >= entities.size())
+                return false;
+            if (auto & target = entities[event.rhs]; target.kind == entity_kind::monster)
+                target.hp -= std::min<unsigned int>(event.outcome, target.hp); // as monster::damage
+            ++interactions;
+            return true;
+        }
+    };
+
+    // The entity loop, shared by recording runs and live replays :
+    // one std::visit + behave() per entity, reporting each hp change.
+    template <typename element_type, typename hp_change_handler_type>
+    void behave_tick(std::span<element_type> entities, hp_change_handler_type && on_hp_change)
+    {
+        for (std::size_t index = 0; index != entities.size(); ++index)
+        {
+            auto & element = entities[index];
+            const auto get_hp = [&element]{ return std::visit([](const auto & value){ return value.get_hp(); }, element); };
+            const auto hp_before = get_hp();
+            std::visit([](auto & value){ value.behave(); }, element);
+            if (const auto delta = static_cast<std::int64_t>(get_hp()) - hp_before; delta != 0)
+                on_hp_change(hp_change_event{ index, delta });
+        }
+    }
+    // lhs deals `amount` damage to rhs, if rhs can take any
+    template <typename element_type>
+    void interact(element_type & lhs, element_type & rhs, unsigned int amount)
+    {
+        std::visit([amount](auto &, auto & target){
+            if constexpr (requires { target.damage(amount); })
+                target.damage(amount);
+        }, lhs, rhs);
+    }
+
+    // Live state : real entities. Feeds the recorded inputs back into the entities' code
+    // (spawns, despawns, `interact`, then `behave_tick` at the end of each tick),
+    // and rejects a tick whose recomputed hp changes differ from the recorded ones.
+    struct live_world
+    {
+        using element_type = usage::cpp20::entity_variant<usage::hero, usage::monster>;
+
+        std::vector<element_type> entities;
+        std::vector<std::int64_t> recorded_deltas; // current tick's hp changes, by entity
+
+        live_world() = default;
+        // resumes from a fast-forwarded state
+        explicit live_world(const headless_world & state)
+        {
+            entities.reserve(state.entities.size());
+            for (const auto & value : state.entities)
+                (*this)(spawn_event{ value.kind, value.hp });
+        }
+
+        auto operator()(const spawn_event & event) -> bool
+        {
+            if (event.kind == entity_kind::hero)
+                entities.emplace_back(usage::hero{});
+            else
+                entities.emplace_back(usage::monster{ event.hp });
+            return true;
+        }
+        auto operator()(const despawn_event & event) -> bool
+        {
+            if (event.index >= entities.size())
+                return false;
+            entities[event.index] = std::move(entities.back());
+            entities.pop_back();
+            return true;
+        }
+        auto operator()(const hp_change_event & event) -> bool
+        {   // an output : checked against the recomputed one in `end_tick`
+            if (event.index >= entities.size())
+                return false;
+            recorded_deltas.resize(entities.size());
+            recorded_deltas[event.index] = event.delta;
+            return true;
+        }
+        auto operator()(const interaction_event & event) -> bool
+        {
+            if (event.lhs >= entities.size() or event.rhs >= entities.size())
+                return false;
+            interact(entities[event.lhs], entities[event.rhs], event.outcome);
+            return true;
+        }
+        auto end_tick() -> bool
+        {
+            recorded_deltas.resize(entities.size());
+            bool deterministic = true;
+            behave_tick(std::span{ entities }, [this, &deterministic](const hp_change_event & event){
+                deterministic = deterministic and std::exchange(recorded_deltas[event.index], 0) == event.delta;
+            });
+            deterministic = deterministic and std::ranges::all_of(recorded_deltas, [](auto delta){ return delta == 0; });
+            std::ranges::fill(recorded_deltas, 0);
+            return deterministic;
+        }
+    };
+
+    // Jumps to tick `tick_index` headless, then runs only that tick live : e.g. to profile the tick that spiked.
+    // std::nullopt if the log has no such tick, or on error.
+    inline auto replay_tick(std::span<const std::uint8_t> log, std::size_t tick_index) -> std::optional<live_world>
+    {
+        auto log_replayer = replayer{ log };
+        auto state = headless_world{};
+        for (std::size_t tick = 0; tick != tick_index; ++tick)
+            if (not log_replayer.next_tick(state))
+                return std::nullopt;
+        auto world = live_world{ state };
+        if (not log_replayer.next_tick(world))
+            return std::nullopt;
+        return world;
+    }
+}
+
+namespace usage::cpp20
+{
+    auto use_replay()
+    {
+        using element_type = replay::live_world::element_type;
+        const auto get_hp = [](const element_type & element){
+            return std::visit([](const auto & value){ return value.get_hp(); }, element);
+        };
+        const auto sum_hp = [get_hp](auto intermediate_sum, const auto & element){
+            if constexpr (std::is_same_v<std::decay_t<decltype(element)>, element_type>)
+                return get_hp(element) + intermediate_sum;
+            else
+                return element.hp + intermediate_sum;
+        };
+
+        auto log = replay::recorder{};
+        auto entity_collection = std::vector<element_type>{};
+
+        for (auto tick = 0; tick != 3; ++tick)
+        {
+            log.begin_tick();
+            // inputs first
+            if (tick == 0)
+            {
+                entity_collection.emplace_back(hero{});
+                log.record(replay::spawn_event{ replay::entity_kind::hero, get_hp(entity_collection.back()) });
+                entity_collection.emplace_back(monster{ 42 });
+                log.record(replay::spawn_event{ replay::entity_kind::monster, get_hp(entity_collection.back()) });
+            }
+            if (tick == 1)
+            {
+                log.record(replay::interaction_event{ 0, 1, 5 });
+                replay::interact(entity_collection[0], entity_collection[1], 5);
+            }
+            replay::behave_tick(std::span{ entity_collection }, [&log](const replay::hp_change_event & event){
+                log.record(event);
+            });
+        }
+        const auto recorded_hp = std::accumulate(std::cbegin(entity_collection), std::cend(entity_collection), 0u, sum_hp);
+
+        // headless : replays the whole log, tick by tick
+        auto world = replay::headless_world{};
+        auto log_replayer = replay::replayer{ log.data() };
+        while (log_replayer.next_tick(world))
+        {}
+        assert(not log_replayer.failed());
+        [[maybe_unused]] const auto headless_hp = std::accumulate(std::cbegin(world.entities), std::cend(world.entities), 0u, sum_hp);
+        assert(headless_hp == recorded_hp);
+
+        {   // live : runs the entities' code again, checking every recorded hp change
+            auto live = replay::live_world{};
+            auto live_replayer = replay::replayer{ log.data() };
+            while (live_replayer.next_tick(live))
+            {}
+            assert(not live_replayer.failed());
+            assert(std::accumulate(std::cbegin(live.entities), std::cend(live.entities), 0u, sum_hp) == recorded_hp);
+
+            // last tick only
+            [[maybe_unused]] const auto last_tick = replay::replay_tick(log.data(), 2);
+            assert(last_tick and std::accumulate(std::cbegin(last_tick->entities), std::cend(last_tick->entities), 0u, sum_hp) == recorded_hp);
+            assert(not replay::replay_tick(log.data(), 3));
+        }
+        {   // cut by one byte : the last hp change is incomplete
+            auto truncated_world = replay::headless_world{};
+            auto truncated_replayer = replay::replayer{ log.data().first(log.data().size() - 1) };
+            while (truncated_replayer.next_tick(truncated_world))
+            {}
+            assert(truncated_replayer.failed());
+        }
+        {   // unknown entity
+            auto corrupted_log = replay::recorder{};
+            corrupted_log.begin_tick();
+            corrupted_log.record(replay::hp_change_event{ 3, -1 });
+            auto empty_world = replay::headless_world{};
+            auto corrupted_replayer = replay::replayer{ corrupted_log.data() };
+            [[maybe_unused]] const auto replayed = corrupted_replayer.next_tick(empty_world);
+            assert(not replayed and corrupted_replayer.failed());
+        }
+        {   // not what the entities' code produces : rejected by a live replay only
+            auto tampered_log = replay::recorder{};
+            tampered_log.begin_tick();
+            tampered_log.record(replay::spawn_event{ replay::entity_kind::monster, 42 });
+            tampered_log.record(replay::hp_change_event{ 0, -2 });
+            auto headless = replay::headless_world{};
+            auto live = replay::live_world{};
+            [[maybe_unused]] const auto headless_replayed = replay::replayer{ tampered_log.data() }.next_tick(headless);
+            [[maybe_unused]] const auto live_replayed = replay::replayer{ tampered_log.data() }.next_tick(live);
+            assert(headless_replayed and not live_replayed);
+        }
+        {   // index delta too large for a header
+            auto oversized_log = replay::recorder{};
+            [[maybe_unused]] bool rejected = false;
+            try { oversized_log.record(replay::despawn_event{ std::size_t{ 1 } << 62 }); }
+            catch (const std::out_of_range &) { rejected = true; }
+            assert(rejected and oversized_log.data().empty());
+        }
+
+        return recorded_hp;
+    }
+}
+
+// --- Streaming ingestion
+#include <istream>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <stdexcept>
+#include <string>
+namespace ingestion
+{
+    // Trace format : raw sequence of fixed-size `command` records (host endianness).
+    enum class command_kind : std::uint8_t { spawn, behave, damage };
+    struct command
+    {
+        command_kind kind;
+        replay::entity_kind entity; // spawn only
+        std::uint16_t reserved;
+        std::uint32_t target;       // damage : monster index
+        std::uint32_t value;        // spawn : hp, damage : amount
+    };
+    static_assert(sizeof(command) == 12 and std::is_trivially_copyable_v<command>);
+
+    // Commands of one chunk, grouped into runs of consecutive commands of the same type.
+    // Runs are applied in trace order, so the result does not depend on the chunk size.
+    struct command_batch
+    {
+        enum class run_kind : std::uint8_t { hero_spawns, monster_spawns, damages, behave_passes };
+        struct run
+        {
+            run_kind kind;
+            std::size_t count;
+        };
+        std::vector<run> runs;
+        std::vector<unsigned int> monster_spawns;
+        std::vector<std::pair<std::uint32_t, unsigned int>> damages;
+
+        void clear()
+        {
+            runs.clear();
+            monster_spawns.clear();
+            damages.clear();
+        }
+        // throws std::runtime_error on an unknown command kind or spawned entity
+        void decode(std::span<const command> commands)
+        {
+            clear();
+            for (const auto & value : commands)
+            {
+                const auto kind = [&value]{
+                    switch (value.kind)
+                    {
+                        case command_kind::spawn:
+                            if (value.entity == replay::entity_kind::hero)
+                                return run_kind::hero_spawns;
+                            if (value.entity == replay::entity_kind::monster)
+                                return run_kind::monster_spawns;
+                            throw std::runtime_error{ "ingestion : unknown entity " + std::to_string(static_cast<int>(value.entity)) };
+                        case command_kind::damage:
+                            return run_kind::damages;
+                        case command_kind::behave:
+                            return run_kind::behave_passes;
+                    }
+                    throw std::runtime_error{ "ingestion : unknown command " + std::to_string(static_cast<int>(value.kind)) };
+                }();
+                if (runs.empty() or runs.back().kind != kind)
+                    runs.push_back({ kind, 0 });
+                ++runs.back().count;
+
+                if (kind == run_kind::monster_spawns)
+                    monster_spawns.push_back(value.value);
+                else if (kind == run_kind::damages)
+                    damages.emplace_back(value.target, value.value);
+            }
+        }
+    };
+
+    // Double-buffered : while `consume` processes one batch,
+    // a single reader thread reads and decodes the next chunk into the other buffer.
+    // Memory stays bounded to two chunks, whatever the trace size.
+    // Decoding errors are rethrown on the caller's thread, once every batch before them was consumed;
+    // so is a trailing partial record (std::runtime_error).
+    template <typename consumer_type>
+    auto stream_commands(std::istream & input, std::size_t commands_per_chunk, consumer_type && consume) -> std::size_t
+    {
+        struct buffer_type
+        {
+            std::vector<command> commands;
+            command_batch batch;
+            std::size_t count = 0;  // 0 : end of input
+            bool ready = false;     // filled : owned by the consumer until it hands it back
+        };
+        auto buffers = std::array<buffer_type, 2>{};
+        for (auto & buffer : buffers)
+            buffer.commands.resize(commands_per_chunk);
+
+        auto mutex = std::mutex{};
+        auto changed = std::condition_variable_any{};
+        auto error = std::exception_ptr{};
+        std::size_t trailing_bytes = 0; // reader's, until the end-of-input buffer is ready
+
+        // stopped and joined on scope exit, e.g. if `consume` throws
+        auto reader = std::jthread{ [&](std::stop_token stop){
+            for (std::size_t current = 0;; current ^= 1)
+            {
+                auto & buffer = buffers[current];
+                {
+                    auto lock = std::unique_lock{ mutex };
+                    if (not changed.wait(lock, stop, [&buffer]{ return not buffer.ready; }))
+                        return;
+                }
+                try
+                {
+                    input.read(
+                        reinterpret_cast<char*>(buffer.commands.data()),
+                        static_cast<std::streamsize>(buffer.commands.size() * sizeof(command))
+                    );
+                    const auto bytes = static_cast<std::size_t>(input.gcount());
+                    buffer.count = bytes / sizeof(command);
+                    trailing_bytes += bytes % sizeof(command);
+                    buffer.batch.decode(std::span{ buffer.commands }.first(buffer.count));
+                }
+                catch (...)
+                {
+                    const auto lock = std::scoped_lock{ mutex };
+                    error = std::current_exception();
+                    changed.notify_all();
+                    return;
+                }
+                {
+                    const auto lock = std::scoped_lock{ mutex };
+                    buffer.ready = true;
+                }
+                changed.notify_all();
+                if (buffer.count == 0)
+                    return;
+            }
+        } };
+
+        std::size_t total = 0;
+        for (std::size_t current = 0;; current ^= 1)
+        {
+            auto & buffer = buffers[current];
+            {
+                auto lock = std::unique_lock{ mutex };
+                changed.wait(lock, [&]{ return buffer.ready or error; });
+                if (not buffer.ready)
+                    std::rethrow_exception(error);
+            }
+            if (buffer.count == 0)
+                break;
+            total += buffer.count;
+            consume(std::as_const(buffer.batch));
+            {
+                const auto lock = std::scoped_lock{ mutex };
+                buffer.ready = false;
+            }
+            changed.notify_all();
+        }
+        if (trailing_bytes != 0)
+            throw std::runtime_error{ "ingestion : trailing partial command (" + std::to_string(trailing_bytes) + " bytes)" };
+        return total;
+    }
+
+    struct world
+    {
+        std::vector<usage::hero> heroes;
+        std::vector<usage::monster> monsters;
+
+        void apply(const command_batch & batch)
+        {
+            using run_kind = command_batch::run_kind;
+            auto monster_spawns = std::span{ batch.monster_spawns };
+            auto damages = std::span{ batch.damages };
+            for (const auto & [kind, count] : batch.runs)
+            {
+                switch (kind)
+                {
+                    case run_kind::hero_spawns:
+                        heroes.resize(heroes.size() + count);
+                        break;
+                    case run_kind::monster_spawns:
+                        monsters.insert(std::end(monsters), std::cbegin(monster_spawns), std::cbegin(monster_spawns) + static_cast<std::ptrdiff_t>(count));
+                        monster_spawns = monster_spawns.subspan(count);
+                        break;
+                    case run_kind::damages:
+                        for (const auto & [target, amount] : damages.first(count))
+                            if (target < monsters.size())
+                                monsters[target].damage(amount);
+                        damages = damages.subspan(count);
+                        break;
+                    case run_kind::behave_passes:
+                        for (std::size_t pass = 0; pass != count; ++pass)
+                        {
+                            usage::cpp20::behave_all(std::span{ heroes });
+                            usage::cpp20::behave_all(std::span{ monsters });
+                        }
+                        break;
+                }
+            }
+        }
+        auto hp() const
+        {
+            const auto sum_hp = [](std::uint64_t intermediate_sum, const auto & element){
+                return element.get_hp() + intermediate_sum;
+            };
+            return
+                std::accumulate(std::cbegin(heroes), std::cend(heroes), std::uint64_t{}, sum_hp) +
+                std::accumulate(std::cbegin(monsters), std::cend(monsters), std::uint64_t{}, sum_hp)
+            ;
+        }
+    };
+
+    void write(std::ostream & output, std::span<const command> commands)
+    {
+        output.write(
+            reinterpret_cast<const char*>(commands.data()),
+            static_cast<std::streamsize>(commands.size_bytes())
+        );
+    }
+}
+
+#include <sstream>
+namespace usage::cpp20
+{
+    auto use_ingestion()
+    {
+        using ingestion::command;
+        using ingestion::command_kind;
+        using replay::entity_kind;
+
+        const auto ingest = [](std::span<const command> commands, std::size_t commands_per_chunk, std::size_t trailing_bytes = 0){
+            auto trace = std::stringstream{ std::ios::in | std::ios::out | std::ios::binary };
+            ingestion::write(trace, commands);
+            trace.write("\0\0\0\0\0\0\0\0\0\0\0", static_cast<std::streamsize>(trailing_bytes));
+
+            auto entities = ingestion::world{};
+            ingestion::stream_commands(trace, commands_per_chunk, [&entities](const ingestion::command_batch & batch){
+                entities.apply(batch);
+            });
+            return entities.hp();
+        };
+
+        const auto commands = std::array{
+            command{ command_kind::spawn,  entity_kind::hero,    0, 0, 0 },
+            command{ command_kind::damage, {},                   0, 0, 5 },  // no monster yet : ignored
+            command{ command_kind::spawn,  entity_kind::monster, 0, 0, 42 },
+            command{ command_kind::behave, {},                   0, 0, 0 },
+            command{ command_kind::damage, {},                   0, 0, 10 },
+            command{ command_kind::spawn,  entity_kind::monster, 0, 0, 3 },
+            command{ command_kind::behave, {},                   0, 0, 0 },
+            command{ command_kind::damage, {},                   0, 1, 2 },
+        };
+        // same trace, same result : whatever the chunk size
+        const auto expected = ingest(commands, 1);
+        for (std::size_t commands_per_chunk = 2; commands_per_chunk <= commands.size() + 1; ++commands_per_chunk)
+            assert(ingest(commands, commands_per_chunk) == expected);
+
+        // trailing partial record
+        [[maybe_unused]] bool reported = false;
+        try { ingest(commands, 3, 5); }
+        catch (const std::runtime_error &) { reported = true; }
+        assert(reported);
+
+        // corrupted records : unknown command, unknown entity
+        for (const auto & corrupted : {
+            command{ static_cast<command_kind>(0xff), {}, 0, 0, 0 },
+            command{ command_kind::spawn, static_cast<entity_kind>(0xff), 0, 0, 0 },
+        })
+        {
+            reported = false;
+            try { ingest(std::array{ commands[0], corrupted, commands[1] }, 2); }
+            catch (const std::runtime_error &) { reported = true; }
+            assert(reported);
+        }
+
+        return expected;
+    }
+}
+
 // --- Bonus : flexible contracts
 
 template <bool condition>
@@ -362,12 +1657,249 @@ namespace function_contract
     }
 }
 
+// --- Benchmarks
+#include <chrono>
+#include <random>
+#include <array>
+#include <cstdint>
+#include <string_view>
+namespace benchmarks
+{
+    template <typename function_type>
+    auto measure(function_type && function)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    }
+}
+namespace benchmarks::clustered_iteration
+{
+    template <std::size_t id>
+    struct entity
+    {
+        void behave() { hp -= id % 3 + 1; }
+        auto get_hp() const -> unsigned int { return hp; }
+        unsigned int hp = 1'000'000;
+    };
+
+    // insertion order : `type_count` types, shuffled.
+    // use `perf stat -e branch-misses,cache-misses` to observe the misprediction side.
+    template <std::size_t type_count>
+    void run(std::size_t element_count, std::size_t iterations)
+    {
+        using type_erasure::cpp17::any_entity;
+
+        const auto factories = []<std::size_t ... ids>(std::index_sequence<ids...>){
+            return std::array<any_entity(*)(), sizeof...(ids)>{
+                +[]{ return any_entity{ entity<ids>{} }; }...
+            };
+        }(std::make_index_sequence<type_count>{});
+
+        auto type_indexes = std::vector<std::size_t>(element_count);
+        for (std::size_t index = 0; index != element_count; ++index)
+            type_indexes[index] = index % type_count;
+        std::shuffle(std::begin(type_indexes), std::end(type_indexes), std::mt19937{ 42 });
+
+        auto interleaved = std::vector<any_entity>{};
+        interleaved.reserve(element_count);
+        auto clustered = type_erasure::cpp17::clustered_entity_collection{};
+        for (const auto type_index : type_indexes)
+        {
+            interleaved.push_back(factories[type_index]());
+            clustered.push_back(factories[type_index]());
+        }
+        clustered.recluster();
+
+        const auto interleaved_duration = measure([&]{
+            for (std::size_t iteration = 0; iteration != iterations; ++iteration)
+                for (auto & element : interleaved)
+                    element.behave();
+        });
+        const auto clustered_duration = measure([&]{
+            for (std::size_t iteration = 0; iteration != iterations; ++iteration)
+                clustered.behave_all();
+        });
+
+        const auto sum_hp = [](std::uint64_t intermediate_sum, const any_entity & element){
+            return element.get_hp() + intermediate_sum;
+        };
+        const auto consistent =
+            std::accumulate(std::cbegin(interleaved), std::cend(interleaved), std::uint64_t{}, sum_hp) ==
+            std::accumulate(std::cbegin(clustered), std::cend(clustered), std::uint64_t{}, sum_hp)
+        ;
+        std::cout
+            << "clustered_iteration<" << type_count << "> : "
+            << "interleaved " << interleaved_duration.count() << "us, "
+            << "clustered " << clustered_duration.count() << "us"
+            << (consistent ? "" : " (MISMATCH)") << '\n'
+        ;
+    }
+}
+namespace benchmarks::spawn_contention
+{
+    // `producer_count` threads spawn concurrently while the owner drains once per tick.
+    // Pools are sized to hold every spawn : no back-pressure nor allocation, only contention is measured.
+    void run(std::size_t producer_count, std::size_t spawns_per_producer)
+    {
+        auto spawns = spawning::cpp20::spawn_queue<usage::monster>{};
+        auto monsters = std::vector<usage::monster>{};
+        const auto total = producer_count * spawns_per_producer;
+
+        auto spawn_durations = std::vector<std::chrono::nanoseconds>(producer_count);
+        std::size_t ticks = 0;
+        const auto duration = measure([&]{
+            auto producers = std::vector<std::jthread>{};
+            for (std::size_t index = 0; index != producer_count; ++index)
+                producers.emplace_back([&spawns, &spawn_duration = spawn_durations[index], spawns_per_producer]{
+                    const auto producer = spawns.make_producer(spawns_per_producer);
+                    const auto start = std::chrono::steady_clock::now();
+                    for (std::size_t count = 0; count != spawns_per_producer; ++count)
+                        producer->spawn(42u);
+                    spawn_duration = std::chrono::steady_clock::now() - start;
+                });
+            for (; monsters.size() != total; ++ticks)
+            {
+                spawns.drain_into(monsters);
+                std::this_thread::yield();
+            }
+        });
+        const auto spawning_duration = std::accumulate(std::cbegin(spawn_durations), std::cend(spawn_durations), std::chrono::nanoseconds{});
+        std::cout
+            << "spawn_contention<" << producer_count << " producers> : "
+            << total << " spawns in " << duration.count() << "us, "
+            << total * 1'000'000 / std::max<std::size_t>(duration.count(), 1) << " spawns/s, "
+            << spawning_duration.count() / static_cast<std::int64_t>(total) << "ns per spawn, "
+            << ticks << " ticks\n"
+        ;
+    }
+}
+namespace benchmarks::replay_log
+{
+    // records `tick_count` ticks of `entity_count` hp changes, then replays them headless, live,
+    // and live for the last tick only
+    void run(std::size_t entity_count, std::size_t tick_count)
+    {
+        auto log = replay::recorder{ entity_count * tick_count * 2 };
+        const auto record_duration = measure([&]{
+            for (std::size_t index = 0; index != entity_count; ++index)
+                log.record(replay::spawn_event{ replay::entity_kind::monster, 1'000 });
+            for (std::size_t tick = 0; tick != tick_count; ++tick)
+            {
+                log.begin_tick();
+                for (std::size_t index = 0; index != entity_count; ++index)
+                    log.record(replay::hp_change_event{ index, -1 });
+            }
+        });
+
+        auto world = replay::headless_world{};
+        std::size_t replayed_ticks = 0;
+        const auto replay_duration = measure([&]{
+            auto log_replayer = replay::replayer{ log.data() };
+            while (log_replayer.next_tick(world))
+                ++replayed_ticks;
+        });
+        auto live = replay::live_world{};
+        std::size_t live_ticks = 0;
+        const auto live_duration = measure([&]{
+            auto log_replayer = replay::replayer{ log.data() };
+            while (log_replayer.next_tick(live))
+                ++live_ticks;
+        });
+        auto last_tick = std::optional<replay::live_world>{};
+        const auto last_tick_duration = measure([&]{
+            last_tick = replay::replay_tick(log.data(), tick_count - 1);
+        });
+        std::cout
+            << "replay_log<" << entity_count << " entities, " << tick_count << " ticks> : "
+            << log.data().size() << " bytes, "
+            << "record " << record_duration.count() << "us, "
+            << "headless " << replay_duration.count() << "us (" << replayed_ticks << " ticks), "
+            << "live " << live_duration.count() << "us (" << live_ticks << " ticks), "
+            << "last tick " << last_tick_duration.count() << "us"
+            << (last_tick ? "" : " (FAILED)") << '\n'
+        ;
+    }
+}
+#include <fstream>
+#include <filesystem>
+namespace benchmarks::streaming_ingestion
+{
+    // writes a `command_count` commands trace to a temporary file, then streams it back
+    void run(std::size_t command_count, std::size_t commands_per_chunk)
+    {
+        using ingestion::command;
+        using ingestion::command_kind;
+
+        const auto path = std::filesystem::temp_directory_path() / "game_example_trace.bin";
+        {
+            auto output = std::ofstream{ path, std::ios::binary };
+            auto chunk = std::vector<command>{};
+            chunk.reserve(commands_per_chunk);
+            for (std::size_t index = 0; index != command_count; ++index)
+            {
+                chunk.push_back(
+                    index % 64 == 0 ? command{ command_kind::spawn, replay::entity_kind::monster, 0, 0, 1'000 } :
+                    index % 4096 == 1 ? command{ command_kind::behave, {}, 0, 0, 0 } :
+                    command{ command_kind::damage, {}, 0, static_cast<std::uint32_t>(index % 1024), 1 }
+                );
+                if (chunk.size() == commands_per_chunk or index + 1 == command_count)
+                {
+                    ingestion::write(output, chunk);
+                    chunk.clear();
+                }
+            }
+        }
+
+        auto entities = ingestion::world{};
+        std::size_t ingested = 0;
+        const auto duration = measure([&]{
+            auto input = std::ifstream{ path, std::ios::binary };
+            ingested = ingestion::stream_commands(input, commands_per_chunk, [&entities](const ingestion::command_batch & batch){
+                entities.apply(batch);
+            });
+        });
+        std::filesystem::remove(path);
+
+        std::cout
+            << "streaming_ingestion<" << commands_per_chunk << " per chunk> : "
+            << ingested << " commands in " << duration.count() << "us, "
+            << entities.monsters.size() << " monsters\n"
+        ;
+    }
+}
+
 #include <iostream>
-auto main() -> int
+auto main(int argc, char * argv[]) -> int
 {
+    if (argc > 1 and std::string_view{ argv[1] } == "--benchmark")
+    {
+        constexpr auto element_count = std::size_t{ 1 << 16 };
+        constexpr auto iterations = std::size_t{ 100 };
+        benchmarks::clustered_iteration::run<8>(element_count, iterations);
+        benchmarks::clustered_iteration::run<16>(element_count, iterations);
+        benchmarks::clustered_iteration::run<32>(element_count, iterations);
+        benchmarks::clustered_iteration::run<64>(element_count, iterations);
+
+        for (auto producer_count : { 1, 2, 4, 8, 16, 32 })
+            benchmarks::spawn_contention::run(producer_count, (1 << 20) / producer_count);
+
+        benchmarks::replay_log::run(1'000, 1'000);
+
+        for (auto commands_per_chunk : { 1 << 12, 1 << 16 })
+            benchmarks::streaming_ingestion::run(1 << 22, commands_per_chunk);
+        return 0;
+    }
+
+    usage::cpp17::check_flyweight();
     std::cout
         << "cpp17 : " << usage::cpp17::use_entity_type_erasure() << '\n'
+        << "cpp17 (clustered) : " << usage::cpp17::use_clustered_collection() << '\n'
         << "cpp20 : " << usage::cpp20::use_entity_type_erasure() << '\n'
+        << "cpp20 (batch) : " << usage::cpp20::use_entity_batches() << '\n'
+        << "cpp20 (spawn queue) : " << usage::cpp20::use_spawn_queue() << '\n'
+        << "cpp20 (replay) : " << usage::cpp20::use_replay() << '\n'
+        << "cpp20 (ingestion) : " << usage::cpp20::use_ingestion() << '\n'
         ;
     flexible_concepts::cpp20::usage::use();
 }
@@ -1,6 +1,10 @@
 #include <concepts>
 #include <type_traits>
 #include <algorithm>
+#include <iterator>
+#include <string_view>
+#include <cstdint>
+#include "../type_identity.hpp"
 
 namespace mp
 {
@@ -212,6 +216,9 @@ namespace using_contracts::sample
     using female_cat = animal_type<cat_species, cat_species::female>;
     static_assert(concepts::mammal<female_cat>);
 
+    static_assert(mp::type_id_v<male_cat> != mp::type_id_v<female_cat>);
+    static_assert(mp::type_id_v<male_cat> != mp::type_id_v<male_mouse>);
+
     template <class feline_type>
         requires
             concepts::predator_of<feline_type, mouse_species> &&
@@ -243,60 +250,1019 @@ namespace using_contracts::sample
 #include <variant>
 #include <array>
 #include <ranges>
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+#include <memory>
 
 #include <iostream>
-#include <typeinfo>
 namespace using_contracts::sample
 {
     template <using_contracts::concepts::animal ... animal_type>
     static constexpr auto animal_collection_v = std::array<std::variant<animal_type...>, sizeof...(animal_type)>{ animal_type{}...};
 
+    enum class interaction_kind { copulate, hunt, ignore };
+    template <interaction_kind kind>
+    using interaction_kind_t = std::integral_constant<interaction_kind, kind>;
+
+    // each overload reports the interaction it performed, as a type :
+    // see `dispatched_interaction_v`
+    const auto interaction_behaviors = mp::overload
+    {
+        []<concepts::animal T, concepts::animal U>(T&, U&)
+            requires
+                concepts::can_copulate<T,U>
+        {
+            // copulate
+            std::cout << "copulate :\n\t" << mp::type_name_v<T> << "\nand\n\t" << mp::type_name_v<U> << '\n';
+            return interaction_kind_t<interaction_kind::copulate>{};
+        },
+        []<concepts::animal T, concepts::animal U>(T & T_value, U & U_value)
+            requires
+                concepts::predator_of<T,U> ||
+                concepts::predator_of<U,T>
+        {
+            std::cout << "hunt :\n\t" << mp::type_name_v<T> << "\nand\n\t" << mp::type_name_v<U> << '\n';
+
+            if constexpr (concepts::predator_of<T,U>)
+                T_value.hunt(U_value);
+            if constexpr (concepts::predator_of<U, T>)
+                U_value.hunt(T_value);
+            return interaction_kind_t<interaction_kind::hunt>{};
+        },
+        []<typename T, typename U>(T &, U &)
+        {
+            // ignore each others
+            std::cout << "ignore :\n\t" << mp::type_name_v<T> << "\nand\n\t" << mp::type_name_v<U> << '\n';
+            return interaction_kind_t<interaction_kind::ignore>{};
+        }
+    };
+    // interaction selected by interaction_behaviors' overload resolution (unevaluated : no side effect)
+    template <concepts::animal T, concepts::animal U>
+    constexpr auto dispatched_interaction_v = decltype(interaction_behaviors(std::declval<T&>(), std::declval<U&>()))::value;
+
+    // Resumable walk over the N * (N - 1) ordered pairs of a collection.
+    // Each `step` consumes at most a given budget (pairs or time), then returns;
+    // the next call resumes where the previous one stopped,
+    // so every pair is visited exactly once per full cycle.
+    // A step never crosses a cycle boundary : it returns early once the cycle completes.
+    // Resizing the collection in the middle of a cycle restarts that cycle from its first pair.
+    template <std::ranges::random_access_range collection_type, typename behaviors_type>
+    class simulation_cursor
+    {
+    public:
+        struct progress_type
+        {
+            std::size_t pairs_visited;      // in the current cycle
+            std::size_t pairs_per_cycle;
+            std::size_t completed_cycles;
+
+            constexpr auto ratio() const -> double
+            {
+                return pairs_per_cycle == 0
+                    ? 1.0
+                    : static_cast<double>(pairs_visited) / static_cast<double>(pairs_per_cycle)
+                ;
+            }
+        };
+
+        constexpr simulation_cursor(collection_type & collection_arg, behaviors_type behaviors_arg)
+        : collection{ collection_arg }
+        , behaviors{ std::move(behaviors_arg) }
+        {}
+
+        constexpr auto pairs_per_cycle() const -> std::size_t
+        {
+            const auto size = std::ranges::size(collection);
+            return size < 2 ? 0 : size * (size - 1);
+        }
+        constexpr auto progress() const -> progress_type
+        {
+            return { position, pairs_per_cycle(), completed_cycles };
+        }
+
+        // work budget : visits at most `pairs_budget` pairs
+        constexpr auto step(std::size_t pairs_budget) -> std::size_t
+        {
+            return step_while([&pairs_budget](std::size_t visited){
+                return visited < pairs_budget;
+            });
+        }
+        // time budget : visits pairs until `deadline` is reached.
+        // the clock is sampled every `check_interval` pairs to keep `now()` out of the hot path.
+        template <class clock_type, class duration_type>
+        auto step_until(std::chrono::time_point<clock_type, duration_type> deadline, std::size_t check_interval = 8) -> std::size_t
+        {
+            check_interval = std::max<std::size_t>(check_interval, 1);
+            return step_while([&deadline, check_interval](std::size_t visited){
+                return visited % check_interval != 0 or clock_type::now() < deadline;
+            });
+        }
+
+    private:
+        template <typename predicate_type>
+        constexpr auto step_while(predicate_type && can_continue) -> std::size_t
+        {
+            const auto size = std::ranges::size(collection);
+            if (size != cycle_size)
+            {   // positions are only meaningful for the size the cycle started with
+                cycle_size = size;
+                position = 0;
+            }
+            if (size < 2)
+                return 0;
+
+            std::size_t visited = 0;
+            for (; can_continue(visited); ++visited)
+            {
+                // position -> (lhs, rhs), skipping the lhs == rhs diagonal
+                const auto lhs_index = position / (size - 1);
+                const auto offset = position % (size - 1);
+                const auto rhs_index = offset + (offset >= lhs_index ? 1 : 0);
+
+                std::visit(
+                    [this](auto & lhs, auto & rhs){ behaviors(lhs, rhs); }, // results discarded : may differ per pair
+                    collection[lhs_index], collection[rhs_index]
+                );
+
+                if (++position == pairs_per_cycle())
+                {
+                    position = 0;
+                    ++completed_cycles;
+                    return visited + 1;
+                }
+            }
+            return visited;
+        }
+
+        collection_type & collection;
+        behaviors_type behaviors;
+        std::size_t cycle_size = std::ranges::size(collection);
+        std::size_t position = 0;
+        std::size_t completed_cycles = 0;
+    };
+
+    // ---------- Compile-time evaluation
+    // mirrors interaction_behaviors' overload resolution, checked against it by `evaluate_interactions`
+    template <concepts::animal T, concepts::animal U>
+    consteval auto interaction_of() -> interaction_kind
+    {
+        if constexpr (concepts::can_copulate<T,U>)
+            return interaction_kind::copulate;
+        else if constexpr (concepts::predator_of<T,U> || concepts::predator_of<U,T>)
+            return interaction_kind::hunt;
+        else
+            return interaction_kind::ignore;
+    }
+
+    struct interaction_outcome
+    {
+        std::size_t copulate_count = 0;
+        std::size_t hunt_count = 0;
+        std::size_t ignore_count = 0;
+
+        constexpr void add(interaction_kind kind)
+        {
+            switch (kind)
+            {
+                case interaction_kind::copulate: ++copulate_count; break;
+                case interaction_kind::hunt:     ++hunt_count;     break;
+                case interaction_kind::ignore:   ++ignore_count;   break;
+            }
+        }
+        constexpr bool operator==(const interaction_outcome &) const = default;
+    };
+
+    template <concepts::animal T, concepts::animal ... other_types>
+    consteval auto interaction_row()
+    {
+        return std::array{ interaction_of<T, other_types>()... };
+    }
+    // interaction_table<Ts...>()[i][j] : interaction of the i-th animal with the j-th one
+    template <concepts::animal ... animal_types>
+    consteval auto interaction_table()
+    {
+        return std::array{ interaction_row<animal_types, animal_types...>()... };
+    }
+    template <concepts::animal ... animal_types>
+    constexpr auto interaction_table_v = interaction_table<animal_types...>();
+
+    // outcome of one full simulation cycle, for a population known at compile time
+    template <concepts::animal ... animal_types>
+    consteval auto simulation_outcome() -> interaction_outcome
+    {
+        constexpr auto table = interaction_table<animal_types...>();
+        auto outcome = interaction_outcome{};
+        for (std::size_t lhs = 0; lhs != table.size(); ++lhs)
+            for (std::size_t rhs = 0; rhs != table.size(); ++rhs)
+                if (lhs != rhs)
+                    outcome.add(table[lhs][rhs]);
+        return outcome;
+    }
+    template <concepts::animal ... animal_types>
+    constexpr auto simulation_outcome_v = simulation_outcome<animal_types...>();
+
+    // runtime path : same walk as `simulation()`, dispatched through std::visit,
+    // each pair classified by interaction_behaviors' own overload resolution
+    template <std::ranges::random_access_range collection_type>
+    constexpr auto evaluate_interactions(collection_type collection) -> interaction_outcome
+    {
+        auto outcome = interaction_outcome{};
+        auto cursor = simulation_cursor{
+            collection,
+            [&outcome]<concepts::animal T, concepts::animal U>(T &, U &){
+                outcome.add(dispatched_interaction_v<T, U>);
+            }
+        };
+        cursor.step(cursor.pairs_per_cycle());
+        return outcome;
+    }
+
+    static_assert(
+        evaluate_interactions(animal_collection_v<female_cat, male_cat, female_mouse, male_mouse>) ==
+        simulation_outcome_v<female_cat, male_cat, female_mouse, male_mouse>
+    );
+    static_assert(
+        evaluate_interactions(animal_collection_v<male_cat, female_mouse, male_mouse>) ==
+        simulation_outcome_v<male_cat, female_mouse, male_mouse>
+    );
+
     void simulation()
     {
         auto animals_collection_value = animal_collection_v<female_cat, male_cat, female_mouse, male_mouse>;
 
-        const auto behaviors = mp::overload
+        auto cursor = simulation_cursor{ animals_collection_value, interaction_behaviors };
+        cursor.step(cursor.pairs_per_cycle());
+    }
+
+    void scripted_simulation()
+    {   // no visitation at runtime : the outcome is a compile-time constant
+        constexpr auto outcome = simulation_outcome_v<female_cat, male_cat, female_mouse, male_mouse>;
+        std::cout
+            << "scripted outcome : "
+            << outcome.copulate_count << " copulate, "
+            << outcome.hunt_count << " hunt, "
+            << outcome.ignore_count << " ignore\n"
+        ;
+    }
+
+    void time_sliced_simulation()
+    {   // spreads one cycle over several frames, each frame having a fixed work budget
+        auto animals_collection_value = animal_collection_v<female_cat, male_cat, female_mouse, male_mouse>;
+
+        constexpr auto pairs_per_frame = std::size_t{ 5 };
+        auto cursor = simulation_cursor{ animals_collection_value, interaction_behaviors };
+        for (auto frame = 0; cursor.progress().completed_cycles == 0; ++frame)
+        {
+            cursor.step(pairs_per_frame);
+            const auto progress = cursor.progress();
+            std::cout
+                << "frame " << frame << " : "
+                << progress.pairs_visited << '/' << progress.pairs_per_cycle
+                << " (" << progress.ratio() * 100 << "%), cycles : " << progress.completed_cycles << '\n'
+            ;
+        }
+    }
+}
+
+#include <bit>
+#include <string>
+#include <vector>
+#include <thread>
+#include <optional>
+#include <istream>
+#include <sstream>
+namespace using_contracts::runtime
+{   // Species defined by data, without recompiling.
+    // Mirrors using_contracts::concepts as packed bitmasks, so that pairwise compatibility
+    // reduces to branchless integer tests over contiguous columns.
+
+    namespace traits
+    {
+        using type = std::uint32_t;
+        constexpr auto animal               = type{ 1 << 0 };
+        constexpr auto vertebrate           = type{ 1 << 1 };
+        constexpr auto constant_temperature = type{ 1 << 2 };
+        constexpr auto gendered             = type{ 1 << 3 };
+        constexpr auto mammal               = type{ 1 << 4 };
+
+        // implied traits, as in the concepts' definitions
+        constexpr auto requirements_of(type value) -> type
+        {
+            auto result = type{};
+            if (value & vertebrate)
+                result |= animal;
+            if (value & mammal)
+                result |= vertebrate | animal | constant_temperature | gendered;
+            return result;
+        }
+        inline auto parse(std::string_view name) -> std::optional<type>
+        {
+            if (name == "animal")               return animal;
+            if (name == "vertebrate")           return vertebrate;
+            if (name == "constant_temperature") return constant_temperature;
+            if (name == "gendered")             return gendered;
+            if (name == "mammal")               return mammal;
+            return std::nullopt;
+        }
+    }
+    // male | female == both : opposite genders
+    enum class gender : std::uint8_t { none = 0, male = 1, female = 2, both = 3 };
+
+    using species_id = std::uint8_t;
+    constexpr auto max_species = std::size_t{ 64 }; // one bit per species in `prey_mask`
+
+    struct species_traits
+    {
+        std::string name;
+        traits::type value;
+        std::uint64_t prey_mask = 0; // bit N : hunts species N
+    };
+
+    class species_registry
+    {
+    public:
+        auto add(std::string name, traits::type value) -> species_id
+        {
+            if (name.empty())
+                throw std::invalid_argument{ "species_registry : unnamed species" };
+            if (not (value & traits::animal))
+                throw std::invalid_argument{ "species_registry : " + name + " is not an animal" };
+            if (species.size() == max_species)
+                throw std::length_error{ "species_registry : too many species" };
+            if (const auto missing = traits::requirements_of(value) & ~value; missing != 0)
+                throw std::invalid_argument{ "species_registry : unmet requirements for " + name };
+            if (find(name))
+                throw std::invalid_argument{ "species_registry : duplicated species " + name };
+            species.push_back({ std::move(name), value });
+            return static_cast<species_id>(species.size() - 1);
+        }
+        void add_prey(species_id predator, species_id prey)
+        {
+            if (prey >= species.size())
+                throw std::out_of_range{ "species_registry : unknown prey" };
+            species.at(predator).prey_mask |= std::uint64_t{ 1 } << prey;
+        }
+
+        // compile-time types : traits are deduced from the concepts, no parsing involved.
+        // Returns the species_id of each type, in order.
+        template <concepts::animal ... animal_types>
+        auto register_static() -> std::array<species_id, sizeof...(animal_types)>
+        {
+            const auto ids = std::array{ static_species_id<animal_types>()... };
+            [&]<std::size_t ... indexes>(std::index_sequence<indexes...>){
+                (add_static_preys<animal_types, animal_types...>(ids[indexes], ids), ...);
+            }(std::index_sequence_for<animal_types...>{});
+            return ids;
+        }
+
+        // data file, one declaration per line :
+        //  species <name> <trait>...
+        //  hunts <predator> <prey>
+        //  # comment
+        void load(std::istream & input)
+        {
+            for (std::string line; std::getline(input, line);)
+            {
+                auto tokens = std::istringstream{ line };
+                std::string keyword;
+                if (not (tokens >> keyword) or keyword.starts_with('#'))
+                    continue;
+                if (keyword == "species")
+                {
+                    std::string name, trait_name;
+                    tokens >> name;
+                    auto value = traits::type{};
+                    while (tokens >> trait_name)
+                    {
+                        const auto trait = traits::parse(trait_name);
+                        if (not trait)
+                            throw std::invalid_argument{ "species_registry : unknown trait " + trait_name };
+                        value |= *trait | traits::requirements_of(*trait);
+                    }
+                    add(std::move(name), value);
+                }
+                else if (keyword == "hunts")
+                {
+                    std::string predator, prey;
+                    tokens >> predator >> prey;
+                    const auto predator_id = find(predator);
+                    const auto prey_id = find(prey);
+                    if (not predator_id or not prey_id)
+                        throw std::invalid_argument{ "species_registry : unknown species in : " + line };
+                    add_prey(*predator_id, *prey_id);
+                }
+                else
+                    throw std::invalid_argument{ "species_registry : unknown declaration : " + line };
+            }
+        }
+
+        auto find(std::string_view name) const -> std::optional<species_id>
+        {
+            const auto it = std::ranges::find(species, name, &species_traits::name);
+            if (it == std::cend(species))
+                return std::nullopt;
+            return static_cast<species_id>(std::distance(std::cbegin(species), it));
+        }
+        auto operator[](species_id id) const -> const species_traits & { return species[id]; }
+        auto size() const { return species.size(); }
+
+    private:
+        template <typename T>
+        auto static_species_id() -> species_id
+        {
+            using species_type = typename T::species_type;
+            constexpr auto name = mp::type_name_v<species_type>;
+            if (const auto id = find(name))
+                return *id;
+
+            auto value = traits::animal;
+            if constexpr (concepts::vertebrate<T>)               value |= traits::vertebrate;
+            if constexpr (concepts::has_constant_temperature<T>) value |= traits::constant_temperature;
+            if constexpr (concepts::gendered<T>)                 value |= traits::gendered;
+            if constexpr (concepts::mammal<T>)                   value |= traits::mammal;
+            return add(std::string{ name }, value);
+        }
+        template <typename predator_type, typename ... prey_types>
+        void add_static_preys(species_id predator, const std::array<species_id, sizeof...(prey_types)> & prey_ids)
+        {
+            std::size_t index = 0;
+            ((concepts::predator_of<predator_type, prey_types> ? add_prey(predator, prey_ids[index]) : void(), ++index), ...);
+        }
+
+        std::vector<species_traits> species;
+    };
+
+    template <concepts::animal T>
+    constexpr auto gender_of() -> gender
+    {
+        if constexpr (concepts::female<T>)
+            return gender::female;
+        else if constexpr (concepts::male<T>)
+            return gender::male;
+        else
+            return gender::none;
+    }
+
+    // Structure-of-arrays population : one contiguous column per tested property
+    class population
+    {
+    public:
+        explicit population(const species_registry & registry_arg)
+        : registry{ registry_arg }
+        {}
+
+        // an animal is none, male or female : `gender::both` would copulate with itself
+        void add(species_id species, gender gender_value)
+        {
+            if (species >= registry.size())
+                throw std::out_of_range{ "population : unknown species" };
+            if (gender_value >= gender::both) // or out of range
+                throw std::invalid_argument{ "population : gender" };
+            if (not (registry[species].value & traits::gendered))
+                gender_value = gender::none;
+            species_bits.push_back(std::uint64_t{ 1 } << species);
+            prey_masks.push_back(registry[species].prey_mask);
+            genders.push_back(static_cast<std::uint64_t>(gender_value));
+        }
+        auto size() const { return species_bits.size(); }
+
+        // all ordered pairs (lhs != rhs), rows split across `thread_count` threads
+        auto evaluate(std::size_t thread_count = std::thread::hardware_concurrency()) const -> sample::interaction_outcome
+        {
+            thread_count = std::clamp<std::size_t>(thread_count, 1, std::max<std::size_t>(size(), 1));
+            auto partial_outcomes = std::vector<sample::interaction_outcome>(thread_count);
+            {
+                auto workers = std::vector<std::jthread>{};
+                const auto rows_per_thread = (size() + thread_count - 1) / thread_count;
+                for (std::size_t index = 0; index != thread_count; ++index)
+                    workers.emplace_back([&, index]{
+                        const auto first = std::min(index * rows_per_thread, size());
+                        const auto last = std::min(first + rows_per_thread, size());
+                        partial_outcomes[index] = evaluate_rows(first, last);
+                    });
+            }
+            auto result = sample::interaction_outcome{};
+            for (const auto & value : partial_outcomes)
+            {
+                result.copulate_count += value.copulate_count;
+                result.hunt_count += value.hunt_count;
+                result.ignore_count += value.ignore_count;
+            }
+            return result;
+        }
+
+    private:
+        auto evaluate_rows(std::size_t first, std::size_t last) const -> sample::interaction_outcome
         {
-            []<concepts::animal T, concepts::animal U>(T&, U&)
-                requires
-                    concepts::can_copulate<T,U>
+            const auto count = size();
+            const auto * const species_column = species_bits.data();
+            const auto * const prey_column = prey_masks.data();
+            const auto * const gender_column = genders.data();
+
+            auto result = sample::interaction_outcome{};
+            for (std::size_t lhs = first; lhs != last; ++lhs)
             {
-                // copulate
-                std::cout << "copulate :\n\t" << typeid(T).name() << "\nand\n\t" << typeid(U).name() << '\n';
-            },
-            []<concepts::animal T, concepts::animal U>(T & T_value, U & U_value)
-                requires
-                    concepts::predator_of<T,U> ||
-                    concepts::predator_of<U,T>
+                const auto lhs_bit = species_column[lhs];
+                const auto lhs_prey = prey_column[lhs];
+                const auto lhs_gender = gender_column[lhs];
+
+                // branchless, 64-bit lanes only : vectorizable (64-bit compares need SSE4.1, e.g. -march=x86-64-v2)
+                std::uint64_t copulate = 0;
+                std::uint64_t hunt = 0;
+                for (std::size_t rhs = 0; rhs != count; ++rhs)
+                {
+                    const auto can_copulate = static_cast<std::uint64_t>(
+                        (species_column[rhs] == lhs_bit) &
+                        ((gender_column[rhs] | lhs_gender) == static_cast<std::uint64_t>(gender::both))
+                    );
+                    const auto can_hunt = static_cast<std::uint64_t>(
+                        ((lhs_prey & species_column[rhs]) | (prey_column[rhs] & lhs_bit)) != 0
+                    );
+                    copulate += can_copulate;
+                    hunt += can_hunt & (can_copulate ^ 1);
+                }
+                // lhs == rhs : never copulates (`add` rejects gender::both), might "hunt" itself
+                hunt -= (lhs_prey & lhs_bit) != 0;
+
+                result.copulate_count += copulate;
+                result.hunt_count += hunt;
+                result.ignore_count += (count - 1) - copulate - hunt;
+            }
+            return result;
+        }
+
+        const species_registry & registry;
+        std::vector<std::uint64_t> species_bits;
+        std::vector<std::uint64_t> prey_masks;
+        std::vector<std::uint64_t> genders; // same width as the other columns : keeps the loop vectorizable
+    };
+}
+namespace using_contracts::sample
+{
+    void runtime_species()
+    {
+        namespace runtime = using_contracts::runtime;
+
+        auto registry = runtime::species_registry{};
+        // compile-time species first : traits checked by the concepts
+        const auto static_ids = registry.register_static<female_cat, male_cat, female_mouse, male_mouse>();
+        {   // then designers' data
+            auto data = std::istringstream{
+                "# see contract_description.md\n"
+                "species snake vertebrate\n"
+                "species mosquito animal\n"
+                "hunts snake " + std::string{ registry[static_ids[2]].name } + "\n"
+            };
+            registry.load(data);
+        }
+
+        {   // same population as `simulation()` : must match the compile-time outcome
+            auto animals = runtime::population{ registry };
+            animals.add(static_ids[0], runtime::gender_of<female_cat>());
+            animals.add(static_ids[1], runtime::gender_of<male_cat>());
+            animals.add(static_ids[2], runtime::gender_of<female_mouse>());
+            animals.add(static_ids[3], runtime::gender_of<male_mouse>());
+            const auto matches = animals.evaluate() == simulation_outcome_v<female_cat, male_cat, female_mouse, male_mouse>;
+            std::cout << "runtime outcome matches compile-time one : " << std::boolalpha << matches << '\n';
+        }
+        {   // invalid inputs
+            const auto rejects = [](auto && function){
+                try { function(); }
+                catch (const std::logic_error &) { return true; }
+                return false;
+            };
+            const auto rejects_data = [&](std::string data){
+                return rejects([&]{
+                    auto copy = registry;
+                    auto input = std::istringstream{ std::move(data) };
+                    copy.load(input);
+                });
+            };
+            auto animals = runtime::population{ registry };
+            const auto rejected =
+                rejects([&]{ animals.add(static_ids[0], runtime::gender::both); }) and   // copulates with itself
+                rejects([&]{ animals.add(static_cast<runtime::species_id>(registry.size()), runtime::gender::none); }) and
+                rejects_data("species\n") and              // unnamed
+                rejects_data("species beetle\n") and       // not even an animal
+                rejects_data("species beetle gendered\n")
+            ;
+            std::cout << "invalid inputs rejected : " << std::boolalpha << rejected << '\n';
+        }
+
+        auto animals = runtime::population{ registry };
+        for (std::size_t index = 0; index != 1024; ++index)
+            animals.add(
+                static_cast<runtime::species_id>(index % registry.size()),
+                index / registry.size() % 2 ? runtime::gender::male : runtime::gender::female
+            );
+        const auto outcome = animals.evaluate();
+        std::cout
+            << "runtime outcome : "
+            << outcome.copulate_count << " copulate, "
+            << outcome.hunt_count << " hunt, "
+            << outcome.ignore_count << " ignore\n"
+        ;
+    }
+}
+
+#if __has_include(<sys/mman.h>) and __has_include(<sys/wait.h>)
+#include <atomic>
+#include <vector>
+#include <random>
+#include <string>
+#include <new>
+#include <thread>
+#include <chrono>
+#include <cerrno>
+#include <cmath>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+namespace using_contracts::sharding
+{   // One world, several local worker processes.
+    // Animals only interact within `interaction_range` of each other, on a [0, 1) line.
+    // The population is partitioned by spatial region into one POSIX shared-memory segment per shard.
+    // Each tick, neighbouring shards exchange the hunt/copulate candidates close to their shared edge
+    // through lock-free SPSC rings, then evaluate (own, own) and (own, remote) pairs in range :
+    // each ordered pair is counted by its lhs' owner.
+
+    using namespace using_contracts::sample;
+    constexpr auto interaction_table = interaction_table_v<female_cat, male_cat, female_mouse, male_mouse>;
+    constexpr auto type_count = interaction_table.size();
+
+    // types that never hunt nor copulate are not worth sending
+    constexpr auto is_candidate = []{
+        auto result = std::array<bool, type_count>{};
+        for (std::size_t lhs = 0; lhs != type_count; ++lhs)
+            for (std::size_t rhs = 0; rhs != type_count; ++rhs)
+                if (interaction_table[lhs][rhs] != interaction_kind::ignore)
+                    result[lhs] = result[rhs] = true;
+        return result;
+    }();
+
+    struct animal_record
+    {
+        std::uint32_t id;
+        std::uint8_t type_index;    // in interaction_table
+        float position;             // [0, 1)
+    };
+    constexpr auto interaction_range = 1.f / 128;
+    constexpr auto end_of_tick = std::uint8_t{ 0xff };
+
+    // single producer / single consumer, address-free : usable across processes
+    template <typename T, std::size_t capacity>
+    struct spsc_ring
+    {
+        static_assert((capacity & (capacity - 1)) == 0, "capacity must be a power of 2");
+        static_assert(std::atomic<std::uint32_t>::is_always_lock_free);
+
+        auto try_push(const T & value) -> bool
+        {
+            const auto tail_value = tail.load(std::memory_order_relaxed);
+            if (tail_value - head.load(std::memory_order_acquire) == capacity)
+                return false;
+            values[tail_value % capacity] = value;
+            tail.store(tail_value + 1, std::memory_order_release);
+            return true;
+        }
+        auto try_pop(T & value) -> bool
+        {
+            const auto head_value = head.load(std::memory_order_relaxed);
+            if (head_value == tail.load(std::memory_order_acquire))
+                return false;
+            value = values[head_value % capacity];
+            head.store(head_value + 1, std::memory_order_release);
+            return true;
+        }
+        // drops pending values : neither side may be in use
+        void reset()
+        {
+            head.store(0, std::memory_order_relaxed);
+            tail.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        alignas(64) std::atomic<std::uint32_t> head = 0;
+        alignas(64) std::atomic<std::uint32_t> tail = 0;
+        alignas(64) std::array<T, capacity> values;
+    };
+
+    constexpr auto max_shards = std::size_t{ 16 };
+    constexpr auto max_population = std::size_t{ 1 << 14 };
+    // only neighbouring regions can be in range, boundary candidates included (see `run_shard`)
+    static_assert(2 * interaction_range < 1.f / max_shards);
+
+    struct shard_segment
+    {
+        std::size_t population_size = 0;
+        std::array<animal_record, max_population> population;
+        std::array<spsc_ring<animal_record, 1024>, max_shards> inbox; // inbox[from]
+        interaction_outcome outcome;    // copulate and hunt only, see `coordinator::run`
+    };
+
+    // RAII over shm_open + mmap. The creating process unlinks the name on destruction.
+    class shared_segment
+    {
+    public:
+        explicit shared_segment(std::string name_arg)
+        : name{ std::move(name_arg) }
+        {
+            const auto descriptor = ::shm_open(name.c_str(), O_CREAT | O_RDWR, 0600);
+            if (descriptor == -1)
+                throw std::runtime_error{ "shm_open : " + name };
+            if (::ftruncate(descriptor, sizeof(shard_segment)) == -1)
             {
-                std::cout << "hunt :\n\t" << typeid(T).name() << "\nand\n\t" << typeid(U).name() << '\n';
-
-                if constexpr (concepts::predator_of<T,U>)
-                    T_value.hunt(U_value);
-                if constexpr (concepts::predator_of<U, T>)
-                    U_value.hunt(T_value);
-            },
-            [](auto & arg1, auto & arg2)
+                ::close(descriptor);
+                ::shm_unlink(name.c_str());
+                throw std::runtime_error{ "ftruncate : " + name };
+            }
+            address = ::mmap(nullptr, sizeof(shard_segment), PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+            ::close(descriptor);
+            if (address == MAP_FAILED)
             {
-                // ignore each others
-                std::cout << "ignore :\n\t" << typeid(arg1).name() << "\nand\n\t" << typeid(arg2).name() << '\n';
+                ::shm_unlink(name.c_str());
+                throw std::runtime_error{ "mmap : " + name };
             }
+            new (address) shard_segment{};
+        }
+        shared_segment(const shared_segment &) = delete;
+        shared_segment & operator=(const shared_segment &) = delete;
+        ~shared_segment()
+        {
+            std::launder(reinterpret_cast<shard_segment*>(address))->~shard_segment();
+            ::munmap(address, sizeof(shard_segment));
+            ::shm_unlink(name.c_str());
+        }
+
+        auto get() const -> shard_segment & { return *std::launder(reinterpret_cast<shard_segment*>(address)); }
+
+    private:
+        std::string name;
+        void * address = nullptr;
+    };
+
+    inline void add_candidate_pair(interaction_outcome & outcome, std::uint8_t lhs, std::uint8_t rhs)
+    {
+        if (const auto kind = interaction_table[lhs][rhs]; kind != interaction_kind::ignore)
+            outcome.add(kind);
+    }
+    // every (lhs, rhs) pair in range, for lhs in `sorted` (by position)
+    inline void add_pairs_in_range(interaction_outcome & outcome, std::span<const animal_record> sorted, const animal_record & rhs)
+    {
+        auto lhs = std::ranges::lower_bound(sorted, rhs.position - 2 * interaction_range, {}, &animal_record::position);
+        for (; lhs != std::end(sorted) and lhs->position <= rhs.position + 2 * interaction_range; ++lhs)
+            if (&*lhs != &rhs and std::abs(lhs->position - rhs.position) <= interaction_range)
+                add_candidate_pair(outcome, lhs->type_index, rhs.type_index);
+    }
+
+    // worker side : runs in a child process. `population` is sorted by position, see `coordinator`.
+    inline void run_shard(std::span<shard_segment * const> shards, std::size_t shard_index, std::size_t tick_count)
+    {
+        auto & self = *shards[shard_index];
+        const auto own = std::span<const animal_record>{ self.population }.first(self.population_size);
+
+        // neighbours only : what they need of us is within range of the shared edge (2x : rounding margin)
+        const auto region_width = 1.f / static_cast<float>(shards.size());
+        auto peers = std::vector<std::size_t>{};
+        auto boundaries = std::vector<std::vector<animal_record>>{};
+        const auto add_peer = [&](std::size_t peer, auto is_near_edge){
+            peers.push_back(peer);
+            std::ranges::copy_if(own, std::back_inserter(boundaries.emplace_back()), [&is_near_edge](const animal_record & value){
+                return is_candidate[value.type_index] and is_near_edge(value.position);
+            });
         };
-        for (auto & animal_value : animals_collection_value)
+        if (shard_index != 0)
+            add_peer(shard_index - 1, [edge = static_cast<float>(shard_index) * region_width](float position){
+                return position < edge + 2 * interaction_range;
+            });
+        if (shard_index + 1 != shards.size())
+            add_peer(shard_index + 1, [edge = static_cast<float>(shard_index + 1) * region_width](float position){
+                return position >= edge - 2 * interaction_range;
+            });
+
+        for (std::size_t tick = 0; tick != tick_count; ++tick)
+        {
+            for (const auto & rhs : own)
+                add_pairs_in_range(self.outcome, own, rhs);
+
+            // interleave sends and receives : rings are bounded, so blocking on a full one could deadlock
+            auto sent = std::vector<std::size_t>(peers.size(), 0);   // candidates + end-of-tick marker
+            auto completed = std::vector<bool>(peers.size(), false); // peer's marker received : what follows is next tick's
+            std::size_t finished_sends = 0;
+            std::size_t completed_peers = 0;
+            while (finished_sends != peers.size() or completed_peers != peers.size())
+            {
+                bool progressed = false;
+                for (std::size_t slot = 0; slot != peers.size(); ++slot)
+                {
+                    const auto & boundary = boundaries[slot];
+                    if (sent[slot] > boundary.size())
+                        continue;
+                    auto & peer_inbox = shards[peers[slot]]->inbox[shard_index];
+                    for (; sent[slot] < boundary.size(); ++sent[slot], progressed = true)
+                        if (not peer_inbox.try_push(boundary[sent[slot]]))
+                            break;
+                    if (sent[slot] == boundary.size() and peer_inbox.try_push(animal_record{ 0, end_of_tick, 0 }))
+                    {
+                        ++sent[slot];
+                        ++finished_sends;
+                        progressed = true;
+                    }
+                }
+                for (std::size_t slot = 0; slot != peers.size(); ++slot)
+                {
+                    if (completed[slot])
+                        continue;
+                    for (auto remote = animal_record{}; self.inbox[peers[slot]].try_pop(remote);)
+                    {
+                        progressed = true;
+                        if (remote.type_index == end_of_tick)
+                        {
+                            completed[slot] = true;
+                            ++completed_peers;
+                            break;
+                        }
+                        add_pairs_in_range(self.outcome, own, remote);
+                    }
+                }
+                if (not progressed) // peers are busy, or share our core
+                    std::this_thread::yield();
+            }
+        }
+    }
+
+    class coordinator
+    {
+    public:
+        coordinator(std::span<const animal_record> population, std::size_t shard_count)
+        {
+            if (shard_count == 0 or shard_count > max_shards)
+                throw std::invalid_argument{ "coordinator : shard_count" };
+            if (population.size() > max_population)
+                throw std::invalid_argument{ "coordinator : population size" };
+
+            const auto prefix = "/iba_shard_" + std::to_string(::getpid()) + '_';
+            segments.reserve(shard_count);
+            for (std::size_t index = 0; index != shard_count; ++index)
+                segments.emplace_back(std::make_unique<shared_segment>(prefix + std::to_string(index)));
+
+            for (const auto & value : population)
+            {   // spatial partitioning
+                const auto region = std::min(static_cast<std::size_t>(value.position * shard_count), shard_count - 1);
+                auto & shard = segments[region]->get();
+                shard.population[shard.population_size++] = value;
+            }
+            for (const auto & segment : segments)
+            {
+                auto & shard = segment->get();
+                std::ranges::sort(std::span{ shard.population }.first(shard.population_size), {}, &animal_record::position);
+            }
+        }
+
+        // forks one worker per shard, waits for all of them, then merges their outcomes.
+        // Throws std::runtime_error if a worker cannot be started or does not exit successfully :
+        // the remaining workers are then killed and reaped.
+        // Reaps any child process (waitpid(-1)) : call it from a process with no other children.
+        auto run(std::size_t tick_count) -> interaction_outcome
         {
-            for (auto & other_animal : animals_collection_value | std::views::filter([&animal_value](auto & rhs) {
-                return &animal_value != &rhs;
-            }))
+            auto shards = std::vector<shard_segment*>{};
+            for (const auto & segment : segments)
+            {   // a previous run may have failed, leaving records in the rings
+                auto & shard = shards.emplace_back(&segment->get());
+                shard->outcome = interaction_outcome{};
+                for (auto & ring : shard->inbox)
+                    ring.reset();
+            }
+
+            std::cout.flush();
+            auto workers = std::vector<pid_t>{};
+            const auto stop_workers = [&workers]{
+                for (const auto pid : workers)
+                    ::kill(pid, SIGKILL);
+                for (const auto pid : workers)
+                    ::waitpid(pid, nullptr, 0);
+                workers.clear();
+            };
+            for (std::size_t index = 0; index != shards.size(); ++index)
+            {
+                const auto pid = ::fork();
+                if (pid == -1)
+                {
+                    stop_workers();
+                    throw std::runtime_error{ "fork" };
+                }
+                if (pid == 0)
+                {
+                    try { run_shard(shards, index, tick_count); }
+                    catch (...) { ::_exit(1); }
+                    ::_exit(0);
+                }
+                workers.push_back(pid);
+            }
+            // in any order : peers of a failed worker would wait for its end-of-tick marker forever
+            while (not workers.empty())
+            {
+                int status = 0;
+                const auto pid = ::waitpid(-1, &status, 0);
+                if (pid == -1 and errno == EINTR)
+                    continue;
+                if (pid == -1)
+                {
+                    stop_workers();
+                    throw std::runtime_error{ "coordinator : waitpid" };
+                }
+                const auto worker = std::ranges::find(workers, pid);
+                if (worker == std::end(workers))
+                    continue;
+                workers.erase(worker);
+                if (not WIFEXITED(status) or WEXITSTATUS(status) != 0)
+                {
+                    stop_workers();
+                    throw std::runtime_error{ "coordinator : worker failed" };
+                }
+            }
+
+            auto result = interaction_outcome{};
+            std::size_t population_size = 0;
+            for (const auto * shard : shards)
             {
-                std::visit(behaviors, animal_value, other_animal);
+                result.copulate_count += shard->outcome.copulate_count;
+                result.hunt_count += shard->outcome.hunt_count;
+                population_size += shard->population_size;
             }
+            // ignored pairs are never exchanged : deduced from the total
+            result.ignore_count =
+                tick_count * population_size * (population_size - 1)
+                - result.copulate_count - result.hunt_count
+            ;
+            return result;
+        }
+
+    private:
+        std::vector<std::unique_ptr<shared_segment>> segments;
+    };
+
+    // reference : every ordered pair in range, single process
+    inline auto expected_outcome(std::span<const animal_record> population, std::size_t tick_count) -> interaction_outcome
+    {
+        auto sorted = std::vector<animal_record>{ std::cbegin(population), std::cend(population) };
+        std::ranges::sort(sorted, {}, &animal_record::position);
+
+        auto result = interaction_outcome{};
+        for (const auto & rhs : sorted)
+            add_pairs_in_range(result, sorted, rhs);
+        result.copulate_count *= tick_count;
+        result.hunt_count *= tick_count;
+        result.ignore_count = tick_count * sorted.size() * (sorted.size() - 1) - result.copulate_count - result.hunt_count;
+        return result;
+    }
+
+    inline void benchmark(std::size_t population_size, std::size_t tick_count, std::size_t max_shard_count)
+    {
+        auto population = std::vector<animal_record>(population_size);
+        auto generator = std::mt19937{ 42 };
+        auto positions = std::uniform_real_distribution<float>{ 0.f, 1.f };
+        for (std::uint32_t id = 0; id != population_size; ++id)
+            population[id] = { id, static_cast<std::uint8_t>(id % type_count), positions(generator) };
+
+        const auto expected = expected_outcome(population, tick_count);
+        for (std::size_t shard_count = 1; shard_count <= max_shard_count; shard_count *= 2)
+        {
+            auto world = coordinator{ population, shard_count };
+            const auto start = std::chrono::steady_clock::now();
+            const auto outcome = world.run(tick_count);
+            const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+            std::cout
+                << "sharded_simulation<" << shard_count << " shards> : "
+                << population_size << " animals, " << tick_count << " ticks in " << duration.count() << "ms"
+                << (outcome == expected ? "" : " (MISMATCH)") << '\n'
+            ;
+        }
+        {   // outcomes are reset on each run : they do not accumulate
+            auto world = coordinator{ std::span{ population }.first(population_size / 8), 2 };
+            const auto first_outcome = world.run(1);
+            std::cout << "sharded_simulation rerun : " << (world.run(1) == first_outcome ? "same outcome" : "MISMATCH") << '\n';
         }
     }
 }
+#endif
 
 // todo : CRTP on models
 
-auto main() -> int
+auto main(int argc, char * argv[]) -> int
 {
+#if __has_include(<sys/mman.h>) and __has_include(<sys/wait.h>)
+    if (argc > 1 and std::string_view{ argv[1] } == "--benchmark")
+    {
+        using_contracts::sharding::benchmark(1 << 14, 16, 8);
+        return 0;
+    }
+#endif
     using_contracts::sample::simulation();
+    using_contracts::sample::time_sliced_simulation();
+    using_contracts::sample::scripted_simulation();
+    using_contracts::sample::runtime_species();
 }
@@ -17,19 +17,25 @@ namespace type_erasure_abstractions
     {
         template <concepts::animal T>
         animal(T && arg)
-        : value_accessor{ std::make_unique<wrapper<T>>(std::forward<decltype(arg)>(arg)) }
+        : value_accessor{ make_model(std::forward<decltype(arg)>(arg)) }
         {}
 
         void behave()
         {
             value_accessor->behave();
         }
+        // shared by all instances of a stateless type
+        auto model_address() const -> const void *
+        {
+            return value_accessor.get();
+        }
 
     private:
         struct model
         {
-            virtual ~model() = 0;
+            virtual ~model() = default;
             virtual void behave() = 0;
+            virtual void release() { delete this; }
         };
         template <typename T>
         struct wrapper : model
@@ -40,7 +46,28 @@ namespace type_erasure_abstractions
             T value;
             void behave(){ value.behave(); }
         };
-        std::unique_ptr<model> value_accessor;
+        // flyweight, as `any_entity` in game_example.cpp : one model per stateless animal type
+        template <typename T>
+        struct shared_wrapper final : wrapper<T>
+        {
+            using wrapper<T>::wrapper;
+            void release() override {}
+        };
+        using model_pointer = std::unique_ptr<model, decltype([](model * value){ value->release(); })>;
+
+        template <typename T>
+        static auto make_model(T && arg) -> model_pointer
+        {
+            using value_type = std::decay_t<T>;
+            if constexpr (std::is_empty_v<value_type> and std::is_trivially_copy_constructible_v<value_type> and std::is_trivially_destructible_v<value_type>)
+            {
+                static auto shared_model = shared_wrapper<value_type>{ value_type{ std::forward<decltype(arg)>(arg) } };
+                return model_pointer{ &shared_model };
+            }
+            return model_pointer{ new wrapper<T>(std::forward<decltype(arg)>(arg)) };
+        }
+
+        model_pointer value_accessor;
     };
 }
 static_assert(concepts::animal<type_erasure_abstractions::animal>);
@@ -57,12 +84,30 @@ struct dog
     void behave() { std::cout << "woof\n"; }
 };
 
+struct counted_cat
+{   // empty, but its destruction is observable : must not be shared
+    static inline int instances = 0;
+    counted_cat() { ++instances; }
+    counted_cat(const counted_cat &) { ++instances; }
+    ~counted_cat() { --instances; }
+    void behave() {}
+};
+
 #include <vector>
+#include <cassert>
 
 auto main() -> int
 {
     auto animals = std::vector<type_erasure_abstractions::animal>{};
     animals.emplace_back(cat{});
     animals.emplace_back(dog{});
+    animals.emplace_back(cat{});
+    assert(animals[0].model_address() == animals[2].model_address());
+
+    animals.emplace_back(counted_cat{});
+    animals.emplace_back(counted_cat{});
+    assert(animals[3].model_address() != animals[4].model_address());
+    animals.pop_back();
+    assert(counted_cat::instances == 1);
 
 }
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+// Shared by species_example and game_example
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+
+namespace mp
+{
+    // RTTI-free type identity, extracted from the compiler's function signature.
+    // Names (thus ids) are stable across builds, but differ from one compiler to another.
+    template <typename T>
+    consteval auto type_name() -> std::string_view
+    {
+    #if defined(__clang__) || defined(__GNUC__)
+        // clang : "auto mp::type_name() [T = int]"
+        // gcc   : "consteval std::string_view mp::type_name() [with T = int; std::string_view = ...]"
+        constexpr auto signature = std::string_view{ __PRETTY_FUNCTION__ };
+        constexpr auto prefix = std::string_view{ "T = " };
+        const auto begin = signature.find(prefix) + prefix.size();
+        const auto end = std::min(signature.find(';', begin), signature.rfind(']'));
+    #elif defined(_MSC_VER)
+        // msvc : "class std::basic_string_view<...> __cdecl mp::type_name<int>(void)"
+        constexpr auto signature = std::string_view{ __FUNCSIG__ };
+        constexpr auto prefix = std::string_view{ "type_name<" };
+        const auto begin = signature.find(prefix) + prefix.size();
+        const auto end = signature.rfind(">(void)");
+    #else
+    #   error "mp::type_name : unsupported compiler"
+    #endif
+        return signature.substr(begin, end - begin);
+    }
+    template <typename T>
+    constexpr auto type_name_v = type_name<T>();
+
+    // FNV-1a, 64 bits
+    consteval auto hash(std::string_view value) -> std::uint64_t
+    {
+        auto result = std::uint64_t{ 14695981039346656037ull };
+        for (const auto character : value)
+        {
+            result ^= static_cast<std::uint8_t>(character);
+            result *= std::uint64_t{ 1099511628211ull };
+        }
+        return result;
+    }
+    template <typename T>
+    constexpr auto type_id_v = hash(type_name_v<T>);
+
+    static_assert(type_name_v<int> == "int");
+    static_assert(type_id_v<int> != type_id_v<unsigned int>);
+}